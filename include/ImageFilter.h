@@ -2,10 +2,63 @@
 #define IMAGE_FILTER_H
 
 #include <vector>
+#include <utility>
+#include <functional>
 #include <cmath>
+#include <cstdint>
 
 using Mat3D = std::vector<std::vector<std::vector<double>>>;
 using Mat2D = std::vector<std::vector<double>>;
+// 整数体数据（8位PNG、12/16位CT等），供定点/整数卷积路径使用
+using Mat3DI = std::vector<std::vector<std::vector<int32_t>>>;
+
+/**
+ * @brief 高斯金字塔的一层
+ * data    该层体数据
+ * spacing 该层物理间距（与read_dcm_series一致：[x, y, z]，单位mm）
+ * factors 相对上一层在各轴上的降采样倍数（[行, 列, 深度]）
+ */
+struct PyramidLevel {
+    Mat3D data;
+    std::vector<double> spacing;
+    std::vector<int> factors;
+};
+
+/**
+ * @brief 局部窗口统计量（与输入同尺寸）
+ * min/max 仅在local_statistics的with_minmax为true时填充，否则为空
+ */
+struct LocalStats {
+    Mat3D mean;
+    Mat3D variance;
+    Mat3D min;
+    Mat3D max;
+};
+
+/**
+ * @brief 增量高斯滤波的缓存
+ * inplane 行、列两轴滤波后的中间结果（逐切片独立，未受修改的切片可直接复用）
+ * 其余字段记录生成缓存时的滤波参数，更新时沿用
+ */
+struct GaussianCache {
+    Mat3D inplane;
+    double sigma = 0.0;
+    int borderType = 1;
+    double cval = 0.0;
+};
+
+/**
+ * @brief 一批同尺寸体数据（或depth=1的2D图像）组成的4D连续块
+ * data按[count][depth][rows][cols]行优先连续存储，
+ * 第i个体数据的(z, r, c)位于 ((i*depth + z)*rows + r)*cols + c
+ */
+struct VolumeBatch {
+    std::vector<double> data;
+    int count = 0;
+    int depth = 0;
+    int rows = 0;
+    int cols = 0;
+};
 
 class ImageFilter {
 public:
@@ -108,7 +161,333 @@ public:
     static Mat3D sobel(const Mat3D& input, int axis = 0,
                       int borderType = 1, double cval = 0.0);
 
+    /**
+     * @brief 对3D矩阵进行1D相关运算并同时沿该轴降采样（平滑与抽取融合）
+     *        只计算保留下来的输出点：output[j] = sum_k weights[k] * input[j*factor + k - k_half]，
+     *        等价于先correlate1d再按[::factor]切片，但计算量为其1/factor
+     * @param input 输入3D矩阵
+     * @param weights 1D卷积核
+     * @param axis 运算轴（0:行, 1:列, 2:深度）
+     * @param factor 降采样倍数（>=1，输出长度为ceil(n/factor)）
+     * @param output 输出结果矩阵
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @throws std::invalid_argument 若轴无效或factor<1
+     */
+    static void correlate1d_decimate(const Mat3D& input, const std::vector<double>& weights,
+                                     int axis, int factor, Mat3D& output,
+                                     int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 高斯平滑并按各轴倍数降采样（类似scipy的gaussian_filter后接[::f]切片）
+     * @param input 输入3D矩阵
+     * @param sigma 高斯标准差（体素单位，仅作用于factor>1的轴）
+     * @param factors 各轴降采样倍数（[行, 列, 深度]）
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @return 降采样后的3D矩阵
+     * @throws std::invalid_argument 若factors元素不足3个或存在<1的倍数
+     */
+    static Mat3D gaussian_downsample(const Mat3D& input, double sigma,
+                                     const std::vector<int>& factors,
+                                     int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 构建多分辨率高斯金字塔（每层由上一层平滑抽取得到，第0层为原始数据）
+     *        各向异性数据按间距决定降采样轴：若某轴间距已不小于最小间距的2倍，
+     *        该层不在此轴上降采样，使各层逐步趋于各向同性
+     * @param input 输入3D矩阵
+     * @param spacing 原始物理间距（[x, y, z]，与read_dcm_series一致）
+     * @param levels 金字塔层数（含第0层）
+     * @param sigma 每层抗混叠高斯标准差（体素单位），默认1.0
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @return 各层数据及其物理间距
+     * @throws std::invalid_argument 若spacing元素不足3个或levels<1
+     */
+    static std::vector<PyramidLevel> gaussian_pyramid(const Mat3D& input,
+                                                      const std::vector<double>& spacing,
+                                                      int levels, double sigma = 1.0,
+                                                      int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 计算局部窗口的均值、方差（可选最小/最大值）
+     *        一次融合扫描同时计算x与x²的滑动和（每轴O(1)/体素，与窗口大小无关），
+     *        最小/最大值采用van Herk/Gil-Werman算法，同样与窗口大小无关。
+     *        窗口语义与scipy.ndimage.uniform_filter一致（偶数尺寸时窗口偏左一位）
+     * @param input 输入3D矩阵
+     * @param size 各轴窗口尺寸（[行, 列, 深度]，均>=1）
+     * @param with_minmax 是否同时计算局部最小/最大值，默认false
+     * @param stable 是否使用数值稳定累加（减去全局均值后做Kahan补偿求和），默认false
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @return 局部统计量
+     * @throws std::invalid_argument 若size元素不足3个或存在<1的尺寸
+     */
+    static LocalStats local_statistics(const Mat3D& input, const std::vector<int>& size,
+                                       bool with_minmax = false, bool stable = false,
+                                       int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 自适应Wiener滤波（与scipy.signal.wiener相同的公式）
+     *        out = mean + max(0, 1 - noise/var) * (x - mean)，局部方差小于噪声时取局部均值
+     * @param input 输入3D矩阵
+     * @param size 各轴窗口尺寸（[行, 列, 深度]）
+     * @param noise 噪声功率；<0时使用局部方差的全局均值估计，默认-1
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @return 滤波后的3D矩阵
+     */
+    static Mat3D wiener_filter(const Mat3D& input, const std::vector<int>& size,
+                               double noise = -1.0, int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 局部对比度归一化：(x - mean) / sqrt(var + eps)
+     * @param input 输入3D矩阵
+     * @param size 各轴窗口尺寸（[行, 列, 深度]）
+     * @param eps 防止除零的小量，默认1e-6
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @return 归一化后的3D矩阵
+     */
+    static Mat3D local_contrast_normalize(const Mat3D& input, const std::vector<int>& size,
+                                          double eps = 1e-6, int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 保边双边滤波（基于双边网格bilateral grid的快速近似）
+     *        将体素按(z, y, x, 灰度)散射到空间步长max(sigma_spatial, 1)、灰度步长sigma_range的4D粗网格，
+     *        模糊后再四线性插值回原分辨率。灰度方向逐层流式处理（体素先按灰度层计数排序），
+     *        任一时刻只保留三个3D空间网格，内存与灰度范围无关，sigma_range始终按给定值生效；
+     *        耗时约与灰度层数×空间网格大小成正比，没有体素的灰度层直接跳过
+     * @param input 输入3D矩阵
+     * @param sigma_spatial 空间高斯标准差（体素单位，三个轴相同）
+     * @param sigma_range 灰度高斯标准差（与输入灰度同单位，如HU）
+     * @return 滤波后的3D矩阵（边界处按有效体素权重归一化，无需边界填充）
+     * @throws std::invalid_argument 若sigma_spatial或sigma_range不为正
+     */
+    static Mat3D bilateral_filter(const Mat3D& input, double sigma_spatial, double sigma_range);
+
+    /**
+     * @brief 将浮点体数据四舍五入为整数体数据
+     * @param input 输入3D矩阵
+     * @return 整数3D矩阵
+     */
+    static Mat3DI to_int_volume(const Mat3D& input);
+
+    /**
+     * @brief 将整数体数据转换为浮点体数据
+     * @param input 输入整数3D矩阵
+     * @param scale 缩放系数（定点结果可传入2^-frac_bits），默认1.0
+     * @return 浮点3D矩阵
+     */
+    static Mat3D to_double_volume(const Mat3DI& input, double scale = 1.0);
+
+    /**
+     * @brief 将浮点核量化为定点整数核，量化后各元素之和严格等于2^frac_bits
+     *        （舍入残差加到中心元素上，保证平坦区域不产生偏移）
+     * @param weights 浮点1D核
+     * @param frac_bits 小数位数
+     * @return 定点整数核
+     */
+    static std::vector<int> quantize_kernel(const std::vector<double>& weights, int frac_bits);
+
+    /**
+     * @brief 整数1D相关运算（int32累加，每行按内存连续方向累加便于编译器使用整数SIMD）
+     *        整数核（如Sobel）且shift=0时结果精确；定点核时结果为
+     *        (sum + 2^(shift-1)) >> shift，即四舍五入到整数。
+     *        调用者需保证 max|input| * sum|weights| < 2^31
+     * @param input 输入整数3D矩阵
+     * @param weights 整数1D卷积核
+     * @param axis 运算轴（0:行, 1:列, 2:深度）
+     * @param output 输出结果矩阵
+     * @param shift 累加结果右移位数（定点核的小数位数），默认0
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0
+     * @throws std::invalid_argument 若轴无效或shift<0
+     */
+    static void correlate1d_int(const Mat3DI& input, const std::vector<int>& weights,
+                                int axis, Mat3DI& output, int shift = 0,
+                                int borderType = 1, int32_t cval = 0);
+
+    /**
+     * @brief 定点3D高斯滤波（各轴依次做定点1D高斯，每轴后四舍五入回整数）
+     *        误差上界：量化后核之和不变（sum_k Δw_k = 0），故每轴误差不超过
+     *        0.5 + (max-min)/2 * sum_k |Δw_k| <= 0.5 + ksize * (max-min) * 2^-(frac_bits+1)，
+     *        三轴累加（中心抽头吸收了其余抽头的舍入余量，最多偏离ksize/2个2^-frac_bits）。
+     *        12位CT、frac_bits=14时最坏情况为每轴0.5+0.125*ksize（sigma=4即ksize=33时约4.6），
+     *        实测随机12位数据sigma=1/2/4时三轴总误差约1.15/1.01/0.90个灰度级。
+     *        溢出条件：max|x| * 2^frac_bits < 2^31（16位输入时frac_bits<=15）
+     * @param input 输入整数3D矩阵
+     * @param sigma 高斯标准差
+     * @param frac_bits 定点核小数位数，默认14
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0
+     * @return 滤波后的整数3D矩阵
+     */
+    static Mat3DI gaussian_filter_int(const Mat3DI& input, double sigma, int frac_bits = 14,
+                                      int borderType = 1, int32_t cval = 0);
+
+    /**
+     * @brief 整数Sobel滤波（{-1,0,1}与{1,2,1}核，int32累加，结果与scipy.ndimage.sobel完全一致）
+     *        输出幅值最多为输入的32倍，16位输入不会溢出
+     * @param input 输入整数3D矩阵
+     * @param axis 梯度方向轴（0:行, 1:列, 2:深度），默认0
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0
+     * @return 梯度计算结果
+     * @throws std::invalid_argument 若轴无效
+     */
+    static Mat3DI sobel_int(const Mat3DI& input, int axis = 0,
+                            int borderType = 1, int32_t cval = 0);
+
+    /**
+     * @brief 3D高斯滤波并保存行、列两轴的中间结果，供gaussian_filter_update增量更新
+     *        结果与gaussian_filter完全相同
+     * @param input 输入3D矩阵
+     * @param sigma 高斯标准差
+     * @param cache 输出的缓存
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @return 滤波后的3D矩阵
+     */
+    static Mat3D gaussian_filter_cached(const Mat3D& input, double sigma, GaussianCache& cache,
+                                       int borderType = 1, double cval = 0.0);
+
+    /**
+     * @brief 部分切片被修改后增量更新高斯滤波结果
+     *        只对修改的切片重做行、列两轴滤波，并只重算距修改切片不超过深度核半径的输出切片，
+     *        耗时与修改切片数成正比，与序列总切片数无关
+     * @param input 修改后的输入3D矩阵（尺寸须与缓存一致）
+     * @param dirty 被修改的切片范围列表，每项为左闭右开区间[begin, end)
+     * @param cache 由gaussian_filter_cached生成的缓存，原地更新
+     * @param output 上一次的滤波结果，原地更新
+     * @throws std::invalid_argument 若尺寸与缓存或输出不一致
+     * @throws std::out_of_range 若切片范围越界
+     */
+    static void gaussian_filter_update(const Mat3D& input,
+                                       const std::vector<std::pair<int, int>>& dirty,
+                                       GaussianCache& cache, Mat3D& output);
+
+    /**
+     * @brief 将多个同尺寸3D矩阵打包为连续的4D批数据
+     * @param volumes 输入体数据列表（2D图像可用depth=1的Mat3D表示）
+     * @return 批数据
+     * @throws std::invalid_argument 若各体数据尺寸不一致
+     */
+    static VolumeBatch make_batch(const std::vector<Mat3D>& volumes);
+
+    /**
+     * @brief 将批数据拆分为3D矩阵列表
+     * @param batch 批数据
+     * @return 体数据列表
+     */
+    static std::vector<Mat3D> unpack_batch(const VolumeBatch& batch);
+
+    /**
+     * @brief 对批数据进行1D相关运算
+     *        核对称性判断、边界索引表、输出内存只在整批上做一次；批内按线程并行。
+     *        当每行很短（小块或2D小图）时，内部转为批维度最内层的交错布局，
+     *        使最内层循环跨批次连续，便于向量化
+     * @param input 输入批数据
+     * @param weights 1D卷积核
+     * @param axis 运算轴（0:行, 1:列, 2:深度）
+     * @param output 输出批数据
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @param num_threads 线程数，<=0时使用硬件线程数，默认0
+     * @throws std::invalid_argument 若轴无效或数据尺寸与count/depth/rows/cols不符
+     */
+    static void correlate1d_batch(const VolumeBatch& input, const std::vector<double>& weights,
+                                  int axis, VolumeBatch& output, int borderType = 1,
+                                  double cval = 0.0, int num_threads = 0);
+
+    /**
+     * @brief 对批数据进行3D高斯滤波（depth=1时深度轴跳过，即逐张2D滤波）
+     * @param input 输入批数据
+     * @param sigma 高斯标准差
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @param num_threads 线程数，<=0时使用硬件线程数，默认0
+     * @return 滤波后的批数据
+     */
+    static VolumeBatch gaussian_filter_batch(const VolumeBatch& input, double sigma,
+                                             int borderType = 1, double cval = 0.0,
+                                             int num_threads = 0);
+
+    /**
+     * @brief 对批数据进行Sobel滤波
+     *        depth=1时跳过深度方向的{1,2,1}平滑，即逐张2D Sobel；非CONSTANT边界下结果为
+     *        对同一depth=1体数据调用sobel的1/4（sobel会沿长度为1的深度轴再乘以1+2+1）
+     * @param input 输入批数据
+     * @param axis 梯度方向轴（0:行, 1:列, 2:深度），默认0
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @param num_threads 线程数，<=0时使用硬件线程数，默认0
+     * @return 梯度计算结果
+     * @throws std::invalid_argument 若轴无效
+     */
+    static VolumeBatch sobel_batch(const VolumeBatch& input, int axis = 0,
+                                   int borderType = 1, double cval = 0.0,
+                                   int num_threads = 0);
+
+    /**
+     * @brief 获取NUMA节点数（仅Linux下读取sysfs，其他平台返回1）
+     * @return NUMA节点数
+     */
+    static int numa_node_count();
+
+    /**
+     * @brief 按z方向切片块（slab）并行执行任务，第t个线程处理[depth*t/T, depth*(t+1)/T)
+     *        同一线程数下划分固定，且第t个线程总是绑定到同一个核（按NUMA节点顺序均匀分布），
+     *        因此在此函数中首次写入的切片会驻留在之后处理它的线程所在节点上
+     * @param depth 切片总数
+     * @param fn 任务函数，参数为切片块[z_begin, z_end)
+     * @param num_threads 线程数，<=0时使用硬件线程数，默认0
+     * @param pin 是否将线程绑定到核，默认true
+     */
+    static void parallel_for_slabs(int depth, const std::function<void(int, int)>& fn,
+                                   int num_threads = 0, bool pin = true);
+
+    /**
+     * @brief 按parallel_for_slabs的划分并行分配并首次写入（first-touch）体数据
+     * @param depth 切片数
+     * @param rows 行数
+     * @param cols 列数
+     * @param num_threads 线程数，<=0时使用硬件线程数，默认0
+     * @param pin 是否将线程绑定到核，默认true
+     * @return 全零3D矩阵，各切片内存位于处理它的线程所在NUMA节点
+     */
+    static Mat3D first_touch_volume(int depth, int rows, int cols,
+                                    int num_threads = 0, bool pin = true);
+
+    /**
+     * @brief NUMA感知的3D高斯滤波：三个轴的滤波都按相同的z切片块划分给同一组绑核线程，
+     *        每个线程的中间结果与输出切片由自己分配，只有深度轴滤波读取相邻块的核半径宽的边缘
+     * @param input 输入3D矩阵（建议由first_touch_volume分配）
+     * @param sigma 高斯标准差
+     * @param borderType 边界填充类型，默认1(REPLICATE)
+     * @param cval 当borderType为CONSTANT时的填充值，默认0.0
+     * @param num_threads 线程数，<=0时使用硬件线程数，默认0
+     * @param pin 是否将线程绑定到核，默认true
+     * @return 滤波后的3D矩阵
+     */
+    static Mat3D gaussian_filter_numa(const Mat3D& input, double sigma, int borderType = 1,
+                                      double cval = 0.0, int num_threads = 0, bool pin = true);
+
 private:
+    /**
+     * @brief 同pad3D，但结果仍计入缓冲池的借出量，供滤波内部作为临时体数据使用
+     *        （用毕须经VolumePool归还或丢弃）
+     */
+    static Mat3D pad3D_pooled(const Mat3D& input, const std::vector<int>& pads,
+                              int borderType, double cval);
+
+    /**
+     * @brief 同correlate1d，但output仍计入缓冲池的借出量，供多趟滤波的中间结果使用
+     */
+    static void correlate1d_pooled(const Mat3D& input, const std::vector<double>& weights,
+                                   int axis, Mat3D& output, int borderType, double cval);
+
     /**
      * @brief 计算边界填充的镜像索引
      * @param idx 原始索引
@@ -118,6 +497,23 @@ private:
      */
     static int getMirrorIndex(int idx, int size, int borderType);
 
+    /**
+     * @brief 计算一条线两端填充后的源索引表
+     * @param size 原始长度
+     * @param before 前端填充量
+     * @param after 后端填充量
+     * @param borderType 边界填充类型
+     * @return 长度为before+size+after的表，第p项为位置p-before对应的源索引（CONSTANT填充处为-1）
+     */
+    static std::vector<int> getSourceIndexTable(int size, int before, int after, int borderType);
+
+    /**
+     * @brief 生成与scipy.ndimage.gaussian_filter1d一致的相关核（半径int(4*sigma+0.5)，已反转）
+     * @param sigma 高斯标准差
+     * @return 相关核
+     */
+    static std::vector<double> getGaussianWeights(double sigma);
+
     /**
      * @brief 获取边界填充值
      * @param input 输入2D矩阵
@@ -0,0 +1,199 @@
+#ifndef VOLUME_POOL_H
+#define VOLUME_POOL_H
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "ImageFilter.h"
+
+/**
+ * @brief 体数据缓冲池的使用统计
+ */
+struct PoolStats {
+    size_t bytes_in_use = 0;    // 已借出且尚未归还或移交的字节数
+    size_t bytes_cached = 0;    // 已归还、等待复用的字节数
+    size_t peak_bytes = 0;      // bytes_in_use + bytes_cached 的历史峰值
+    size_t limit_bytes = 0;     // 内存上限（0表示不限）
+    size_t acquires = 0;        // 借出次数
+    size_t reuses = 0;          // 借出时命中缓存的次数
+    size_t allocations = 0;     // 实际向系统申请内存的次数
+    size_t waits = 0;           // 因超出上限而阻塞等待的次数
+};
+
+/**
+ * @brief 体数据缓冲池：在滤波调用与流水线各阶段之间复用整块体数据和临时缓冲区
+ *        - Mat3D按尺寸复用：连同每行的vector一起回收，避免逐行分配释放造成的堆碎片
+ *        - 原始缓冲区（acquire_buffer）按64字节对齐，>=2MB时按2MB对齐并在Linux上提示使用透明大页；
+ *          对齐只作用于原始缓冲区：池中的Mat3D仍是每行一个vector（行间不连续、不保证对齐），
+ *          pad3D_pooled也仍为每个切片构造一个pad2D的临时Mat2D
+ *        - 借出与缓存的总量受内存上限约束：超出时先释放缓存，仍不足则阻塞等待或立即抛出异常；
+ *          阻塞模式下若其他未在等待的线程借出的内存不足以补足缺口（如只有调用线程自己在借用），
+ *          等待不可能结束，此时同样立即抛出异常
+ *        - 只有通过set_limit设置了上限时才缓存归还的内存（默认不设上限，归还即释放），
+ *          缓存总量因此始终受上限约束，可用trim()随时释放
+ *        所有接口线程安全。全局实例由instance()获取，滤波函数的中间结果（含边界填充）均经由它
+ *        分配，因此内存上限约束的是调用中实际存活的体数据；作为结果返回的体数据在返回前移交给
+ *        调用者，bytes_in_use只反映正在进行的调用。只有与输出同尺寸的临时体数据会进入缓存
+ */
+class VolumePool {
+public:
+    /**
+     * @brief 获取全局缓冲池
+     * @return 全局实例
+     */
+    static VolumePool& instance();
+
+    /**
+     * @brief 设置内存上限（同时开启缓存）
+     * @param bytes 上限字节数（0表示不限，此时不缓存并释放已有缓存）
+     * @param block 超出上限时是否阻塞等待其他线程归还；false时立即抛出异常
+     */
+    void set_limit(size_t bytes, bool block = false);
+
+    /**
+     * @brief 借出指定尺寸的3D矩阵（复用时内容未定义，新分配时为0）
+     * @param depth 切片数
+     * @param rows 行数
+     * @param cols 列数
+     * @return 3D矩阵
+     * @throws std::runtime_error 若非阻塞模式下超出内存上限，或单次请求本身超过上限
+     */
+    Mat3D acquire(int depth, int rows, int cols);
+
+    /**
+     * @brief 归还3D矩阵供后续复用（归还后原对象为空）；未设上限时直接释放
+     *        也接受不是由池借出的体数据（如调用者不再需要的滤波结果），直接纳入缓存
+     * @param volume 待归还的3D矩阵
+     */
+    void release(Mat3D&& volume);
+
+    /**
+     * @brief 丢弃借出的3D矩阵：结束计数并直接释放内存，不纳入缓存
+     *        用于尺寸不会再被请求的临时体数据（如各轴填充量不同的边界填充结果）
+     * @param volume 待丢弃的3D矩阵（丢弃后原对象为空）；不是由池借出的体数据直接释放
+     */
+    void discard(Mat3D&& volume);
+
+    /**
+     * @brief 将借出的3D矩阵移交给调用者（作为滤波结果返回时使用），不再计入bytes_in_use
+     * @param volume 借出的3D矩阵；不是由池借出的体数据被忽略
+     */
+    void detach(const Mat3D& volume);
+
+    /**
+     * @brief 借出对齐的原始缓冲区（内容未定义）
+     * @param count double元素个数
+     * @return 缓冲区指针（64字节对齐，>=2MB时2MB对齐）
+     * @throws std::runtime_error 同acquire
+     */
+    double* acquire_buffer(size_t count);
+
+    /**
+     * @brief 归还由acquire_buffer借出的缓冲区（未设上限时直接释放）
+     * @param buffer 缓冲区指针
+     */
+    void release_buffer(double* buffer);
+
+    /**
+     * @brief 释放所有缓存（不影响已借出的部分）
+     */
+    void trim();
+
+    /**
+     * @brief 查询使用统计
+     * @return 统计信息快照
+     */
+    PoolStats stats() const;
+
+private:
+    VolumePool() = default;
+    ~VolumePool();
+    VolumePool(const VolumePool&) = delete;
+    VolumePool& operator=(const VolumePool&) = delete;
+
+    using Shape = std::tuple<int, int, int>;
+
+    // 原始缓冲区的容量、申请时的对齐方式（释放时必须使用相同的对齐）与借出线程
+    struct BufferInfo {
+        size_t count;
+        size_t alignment;
+        std::thread::id owner;
+    };
+
+    // 为新申请size字节腾出额度（调用时已持有锁）
+    void reserve_locked(std::unique_lock<std::mutex>& lock, size_t size);
+    // 释放一块缓存以腾出额度，无缓存可释放时返回false（调用时已持有锁）
+    bool evict_one_locked();
+    void update_peak_locked();
+    // 按借出线程记账（归还时记到借出线程名下，与归还线程无关）
+    void borrow_locked(std::thread::id owner, size_t size);
+    void give_back_locked(std::thread::id owner, size_t size);
+    // 除self外未在等待的线程借出的字节数，即等待期间可能被归还的上限
+    size_t releasable_by_others_locked(std::thread::id self) const;
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+    std::map<Shape, std::vector<Mat3D>> free_volumes_;
+    std::map<const double*, std::thread::id> outstanding_;  // 已借出体数据（以首行数据地址标识）及借出线程
+    std::multimap<size_t, double*> free_buffers_;        // 容量(元素数) -> 缓冲区
+    std::map<double*, BufferInfo> buffer_sizes_;          // 所有缓冲区的容量与对齐
+    std::map<std::thread::id, size_t> in_use_by_thread_;  // 各线程借出的字节数
+    std::set<std::thread::id> waiting_;                   // 正在阻塞等待的线程
+    PoolStats stats_;
+    bool block_ = false;
+};
+
+/**
+ * @brief 全局缓冲池借出的3D矩阵的作用域守卫：离开作用域时（包括异常退出）将所引用的变量
+ *        归还到缓存（cache为true）或直接丢弃；作为结果返回的体数据需先detach再dismiss
+ */
+class PooledVolumeGuard {
+public:
+    explicit PooledVolumeGuard(Mat3D& volume, bool cache = true) : volume_(&volume), cache_(cache) {}
+    ~PooledVolumeGuard() {
+        if (!volume_) return;
+        if (cache_) {
+            VolumePool::instance().release(std::move(*volume_));
+        } else {
+            VolumePool::instance().discard(std::move(*volume_));
+        }
+    }
+    PooledVolumeGuard(const PooledVolumeGuard&) = delete;
+    PooledVolumeGuard& operator=(const PooledVolumeGuard&) = delete;
+
+    // 不再管理该变量（所引用的体数据已移交给调用者）
+    void dismiss() { volume_ = nullptr; }
+
+private:
+    Mat3D* volume_;
+    bool cache_;
+};
+
+/**
+ * @brief 从全局缓冲池借出的原始缓冲区，离开作用域时自动归还（包括异常退出）
+ */
+class PooledBuffer {
+public:
+    /**
+     * @brief 借出缓冲区
+     * @param count double元素个数
+     * @throws std::runtime_error 同VolumePool::acquire_buffer
+     */
+    explicit PooledBuffer(size_t count) : data_(VolumePool::instance().acquire_buffer(count)) {}
+    ~PooledBuffer() { VolumePool::instance().release_buffer(data_); }
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    double* get() const { return data_; }
+
+private:
+    double* data_;
+};
+
+#endif
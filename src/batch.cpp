@@ -0,0 +1,285 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "ImageFilter.h"
+
+
+// 行长度小于该值时改用批维度最内层的交错布局
+static const int kInterleaveMaxCols = 16;
+
+// 一条长度为len的线上的相关运算计划：整批共享，只构造一次
+struct LinePlan {
+    int len = 0;
+    int ksize = 0;
+    int k_half = 0;
+    int symmetry = 0;            // 0:一般核, 1:对称核, 2:反对称核
+    std::vector<double> weights;
+    std::vector<int> taps;       // [len][ksize]源索引，-1表示CONSTANT填充
+};
+
+// 在[outer][len][inner]布局上执行相关运算，处理outer∈[o0,o1)、inner∈[i0,i1)
+static void apply_plan(const LinePlan& plan, const double* in, double* out,
+                       size_t o0, size_t o1, size_t inner, size_t i0, size_t i1,
+                       const double* const_row) {
+    int len = plan.len;
+    int kh = plan.k_half;
+    const std::vector<double>& w = plan.weights;
+    for (size_t o = o0; o < o1; ++o) {
+        const double* base = in + o * len * inner;
+        auto row = [&](int k, int t) -> const double* {
+            int s = plan.taps[static_cast<size_t>(k) * plan.ksize + t];
+            return s < 0 ? const_row : base + s * inner;
+        };
+        for (int k = 0; k < len; ++k) {
+            double* dst = out + (o * len + k) * inner;
+            if (plan.symmetry == 0) {
+                std::fill(dst + i0, dst + i1, 0.0);
+                for (int t = 0; t < plan.ksize; ++t) {
+                    const double* a = row(k, t);
+                    double wt = w[t];
+                    for (size_t i = i0; i < i1; ++i) dst[i] += a[i] * wt;
+                }
+            } else {
+                const double* c = row(k, kh);
+                double wc = w[kh];
+                for (size_t i = i0; i < i1; ++i) dst[i] = c[i] * wc;
+                for (int t = 1; t <= kh; ++t) {
+                    const double* lo = row(k, kh - t);
+                    const double* hi = row(k, kh + t);
+                    double wt = w[kh + t];
+                    if (plan.symmetry == 1) {
+                        for (size_t i = i0; i < i1; ++i) dst[i] += (hi[i] + lo[i]) * wt;
+                    } else {
+                        for (size_t i = i0; i < i1; ++i) dst[i] += (hi[i] - lo[i]) * wt;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 按线程划分outer（outer不足时划分inner）并执行
+static void run_parallel(const LinePlan& plan, const double* in, double* out,
+                         size_t outer, size_t inner, double cval, int num_threads) {
+    std::vector<double> const_row(inner, cval);
+    size_t threads = num_threads > 0 ? num_threads : std::max(1u, std::thread::hardware_concurrency());
+    bool split_outer = outer >= threads;
+    size_t total = split_outer ? outer : inner;
+    threads = std::min(threads, total);
+
+    if (threads <= 1) {
+        apply_plan(plan, in, out, 0, outer, inner, 0, inner, const_row.data());
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        size_t begin = total * t / threads;
+        size_t end = total * (t + 1) / threads;
+        workers.emplace_back([&, begin, end]() {
+            if (split_outer) {
+                apply_plan(plan, in, out, begin, end, inner, 0, inner, const_row.data());
+            } else {
+                apply_plan(plan, in, out, 0, outer, inner, begin, end, const_row.data());
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+// [count][d][r][c] <-> [d][r][c][count] 转置
+static std::vector<double> interleave(const VolumeBatch& b) {
+    size_t vox = static_cast<size_t>(b.depth) * b.rows * b.cols;
+    std::vector<double> out(b.data.size());
+    for (int n = 0; n < b.count; ++n)
+        for (size_t v = 0; v < vox; ++v) out[v * b.count + n] = b.data[n * vox + v];
+    return out;
+}
+
+static void deinterleave(const std::vector<double>& in, VolumeBatch& b) {
+    size_t vox = static_cast<size_t>(b.depth) * b.rows * b.cols;
+    for (int n = 0; n < b.count; ++n)
+        for (size_t v = 0; v < vox; ++v) b.data[n * vox + v] = in[v * b.count + n];
+}
+
+VolumeBatch ImageFilter::make_batch(const std::vector<Mat3D>& volumes) {
+    VolumeBatch batch;
+    if (volumes.empty() || volumes[0].empty()) return batch;
+    batch.count = volumes.size();
+    batch.depth = volumes[0].size();
+    batch.rows = volumes[0][0].size();
+    batch.cols = volumes[0][0][0].size();
+    batch.data.reserve(static_cast<size_t>(batch.count) * batch.depth * batch.rows * batch.cols);
+
+    for (const Mat3D& vol : volumes) {
+        if (static_cast<int>(vol.size()) != batch.depth) {
+            throw std::invalid_argument("All volumes in a batch must have the same shape");
+        }
+        for (const Mat2D& slice : vol) {
+            if (static_cast<int>(slice.size()) != batch.rows) {
+                throw std::invalid_argument("All volumes in a batch must have the same shape");
+            }
+            for (const auto& row : slice) {
+                if (static_cast<int>(row.size()) != batch.cols) {
+                    throw std::invalid_argument("All volumes in a batch must have the same shape");
+                }
+                batch.data.insert(batch.data.end(), row.begin(), row.end());
+            }
+        }
+    }
+    return batch;
+}
+
+std::vector<Mat3D> ImageFilter::unpack_batch(const VolumeBatch& batch) {
+    std::vector<Mat3D> volumes(batch.count,
+                               Mat3D(batch.depth, Mat2D(batch.rows, std::vector<double>(batch.cols))));
+    const double* p = batch.data.data();
+    for (auto& vol : volumes)
+        for (auto& slice : vol)
+            for (auto& row : slice) {
+                std::copy(p, p + batch.cols, row.begin());
+                p += batch.cols;
+            }
+    return volumes;
+}
+
+// 批数据某轴的长度（0:行, 1:列, 2:深度）
+static int axis_length(const VolumeBatch& shape, int axis) {
+    int lens[3] = {shape.rows, shape.cols, shape.depth};
+    return lens[axis];
+}
+
+// 构造某轴的相关运算计划（对称性判断、边界索引表）
+// index为该轴前填充k_half、后填充ksize-1-k_half后的源索引表
+static LinePlan make_plan(const std::vector<double>& weights, const std::vector<int>& index) {
+    LinePlan plan;
+    plan.ksize = weights.size();
+    plan.k_half = plan.ksize / 2;
+    plan.len = index.size() - plan.ksize + 1;
+    plan.weights = weights;
+
+    bool symmetric = plan.ksize % 2 == 1;
+    bool anti_symmetric = plan.ksize % 2 == 1;
+    for (int i = 1; i <= plan.k_half && (symmetric || anti_symmetric); ++i) {
+        if (!ImageFilter::isClose(weights[plan.k_half + i], weights[plan.k_half - i])) symmetric = false;
+        if (!ImageFilter::isClose(weights[plan.k_half + i], -weights[plan.k_half - i])) anti_symmetric = false;
+    }
+    plan.symmetry = symmetric ? 1 : (anti_symmetric ? 2 : 0);
+
+    plan.taps.resize(static_cast<size_t>(plan.len) * plan.ksize);
+    for (int k = 0; k < plan.len; ++k) {
+        for (int t = 0; t < plan.ksize; ++t) {
+            plan.taps[static_cast<size_t>(k) * plan.ksize + t] = index[k + t];
+        }
+    }
+    return plan;
+}
+
+// 对连续存储的批数据按给定计划执行一趟相关运算；interleaved为true时data为[d][r][c][count]布局
+static void batch_pass(const std::vector<double>& in, std::vector<double>& out,
+                       const VolumeBatch& shape, bool interleaved, const LinePlan& plan,
+                       int axis, double cval, int num_threads) {
+    // 划分为[outer][len][inner]，inner为内存连续段
+    size_t n = shape.count, d = shape.depth, r = shape.rows, c = shape.cols;
+    size_t lanes = interleaved ? n : 1;
+    size_t vols = interleaved ? 1 : n;
+    size_t outer, inner;
+    if (axis == 0) { outer = vols * d; inner = c * lanes; }
+    else if (axis == 1) { outer = vols * d * r; inner = lanes; }
+    else { outer = vols; inner = r * c * lanes; }
+
+    out.resize(in.size());
+    run_parallel(plan, in.data(), out.data(), outer, inner, cval, num_threads);
+}
+
+// 校验批数据并决定是否使用交错布局
+static bool check_batch(const VolumeBatch& input) {
+    size_t vox = static_cast<size_t>(input.depth) * input.rows * input.cols;
+    if (input.data.size() != vox * input.count) {
+        throw std::invalid_argument("Batch data size does not match its shape");
+    }
+    return input.cols < kInterleaveMaxCols && input.count > 1;
+}
+
+// 批量1D相关运算
+void ImageFilter::correlate1d_batch(const VolumeBatch& input, const std::vector<double>& weights,
+                                    int axis, VolumeBatch& output, int borderType,
+                                    double cval, int num_threads) {
+    if (axis < 0 || axis > 2) throw std::invalid_argument("Invalid axis (0-2)");
+    bool interleaved = check_batch(input);
+    output = input;
+    if (input.data.empty() || weights.empty()) return;
+
+    int ksize = weights.size();
+    int k_half = ksize / 2;
+    LinePlan plan = make_plan(weights, getSourceIndexTable(axis_length(input, axis), k_half,
+                                                           ksize - 1 - k_half, borderType));
+    if (interleaved) {
+        std::vector<double> in = interleave(input), out;
+        batch_pass(in, out, input, true, plan, axis, cval, num_threads);
+        deinterleave(out, output);
+    } else {
+        batch_pass(input.data, output.data, input, false, plan, axis, cval, num_threads);
+    }
+}
+
+// 批量高斯滤波（交错布局时整个滤波过程只转置一次）
+VolumeBatch ImageFilter::gaussian_filter_batch(const VolumeBatch& input, double sigma,
+                                               int borderType, double cval, int num_threads) {
+    bool interleaved = check_batch(input);
+    VolumeBatch result = input;
+    if (input.data.empty()) return result;
+
+    auto kernel = getGaussianWeights(sigma);
+    int k_half = kernel.size() / 2;
+
+    std::vector<double> cur = interleaved ? interleave(input) : input.data;
+    std::vector<double> next;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (axis == 2 && input.depth == 1) continue;  // 2D图像批
+        LinePlan plan = make_plan(kernel, getSourceIndexTable(axis_length(input, axis), k_half,
+                                                              k_half, borderType));
+        batch_pass(cur, next, input, interleaved, plan, axis, cval, num_threads);
+        cur.swap(next);
+    }
+
+    if (interleaved) {
+        deinterleave(cur, result);
+    } else {
+        result.data.swap(cur);
+    }
+    return result;
+}
+
+// 批量Sobel滤波
+VolumeBatch ImageFilter::sobel_batch(const VolumeBatch& input, int axis,
+                                     int borderType, double cval, int num_threads) {
+    if (axis < 0 || axis > 2) throw std::invalid_argument("Invalid axis (0-2)");
+    bool interleaved = check_batch(input);
+    VolumeBatch result = input;
+    if (input.data.empty()) return result;
+
+    std::vector<double> cur = interleaved ? interleave(input) : input.data;
+    std::vector<double> next;
+    auto axis_plan = [&](const std::vector<double>& weights, int ax) {
+        return make_plan(weights, getSourceIndexTable(axis_length(input, ax), 1, 1, borderType));
+    };
+    batch_pass(cur, next, input, interleaved, axis_plan({-1, 0, 1}, axis), axis, cval, num_threads);
+    cur.swap(next);
+    // 平滑轴顺序与sobel一致（深度、行、列）
+    const int order[3] = {2, 0, 1};
+    for (int ax : order) {
+        if (ax == axis || (ax == 2 && input.depth == 1)) continue;
+        batch_pass(cur, next, input, interleaved, axis_plan({1, 2, 1}, ax), ax, cval, num_threads);
+        cur.swap(next);
+    }
+
+    if (interleaved) {
+        deinterleave(cur, result);
+    } else {
+        result.data.swap(cur);
+    }
+    return result;
+}
@@ -0,0 +1,160 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "ImageFilter.h"
+#include "VolumePool.h"
+
+
+// 在扁平存储的网格上沿某一维做1D相关（零边界）
+// 网格视为[outer][len][inner]三段，inner段内存连续，便于编译器向量化
+static void blur_grid_axis(double*& grid, double*& temp, size_t total,
+                           size_t outer, int len, size_t inner,
+                           const std::vector<double>& weights) {
+    int k_half = weights.size() / 2;
+    std::fill(temp, temp + total, 0.0);
+    for (size_t o = 0; o < outer; ++o) {
+        const double* src = grid + o * len * inner;
+        double* dst = temp + o * len * inner;
+        for (int k = 0; k < len; ++k) {
+            double* out = dst + k * inner;
+            for (int t = -k_half; t <= k_half; ++t) {
+                int s = k + t;
+                if (s < 0 || s >= len) continue;
+                const double* in = src + s * inner;
+                double w = weights[k_half + t];
+                for (size_t i = 0; i < inner; ++i) out[i] += in[i] * w;
+            }
+        }
+    }
+    std::swap(grid, temp);
+}
+
+// 双边网格快速双边滤波：灰度方向逐层流式处理，任一时刻只保留三个空间网格
+Mat3D ImageFilter::bilateral_filter(const Mat3D& input, double sigma_spatial, double sigma_range) {
+    if (input.empty()) return {};
+    if (sigma_spatial <= 0 || sigma_range <= 0) {
+        throw std::invalid_argument("Bilateral sigmas must be positive");
+    }
+
+    int depth = input.size();
+    int rows = input[0].size();
+    int cols = input[0][0].size();
+    size_t plane = static_cast<size_t>(rows) * cols;
+    size_t voxels = plane * depth;
+
+    double vmin = input[0][0][0], vmax = input[0][0][0];
+    for (const auto& slice : input)
+        for (const auto& row : slice)
+            for (double v : row) {
+                vmin = std::min(vmin, v);
+                vmax = std::max(vmax, v);
+            }
+
+    // 空间网格每格max(sigma_spatial, 1)个体素（细于体素没有意义），模糊核sigma按格换算；
+    // 灰度方向每层恰为sigma_range，层间模糊核sigma为1层
+    const int pad = 2;
+    double step = std::max(sigma_spatial, 1.0);
+    auto kernel = gaussian_kernel1d(sigma_spatial / step, pad);
+    auto range_kernel = gaussian_kernel1d(1.0, pad);
+    int gz = static_cast<int>((depth - 1) / step) + 1 + 2 * pad;
+    int gy = static_cast<int>((rows - 1) / step) + 1 + 2 * pad;
+    int gx = static_cast<int>((cols - 1) / step) + 1 + 2 * pad;
+    int levels = static_cast<int>((vmax - vmin) / sigma_range) + 1;
+
+    // 按灰度所在层（向下取整）对体素做计数排序，之后每层只访问相关的体素
+    std::vector<int> level_of(voxels);
+    std::vector<size_t> start(levels + 1, 0);
+    for (int z = 0; z < depth; ++z)
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c) {
+                int b = std::min(static_cast<int>((input[z][r][c] - vmin) / sigma_range), levels - 1);
+                level_of[z * plane + r * cols + c] = b;
+                ++start[b + 1];
+            }
+    for (int b = 0; b < levels; ++b) start[b + 1] += start[b];
+    std::vector<size_t> order(voxels);
+    {
+        std::vector<size_t> fill(start.begin(), start.end() - 1);
+        for (size_t i = 0; i < voxels; ++i) order[fill[level_of[i]]++] = i;
+    }
+    std::vector<int>().swap(level_of);
+
+    // 每格存放(加权灰度和, 权重和)两个值，作为最内层维度
+    const size_t cell = 2;
+    size_t sx = cell, sy = sx * gx, sz = sy * gy;
+    size_t total = sz * gz;
+    // 当前层、上一层与模糊用的临时网格从缓冲池借出（对齐、异常退出时也会归还）
+    PooledBuffer cur_buffer(total), prev_buffer(total), temp_buffer(total);
+    double* cur = cur_buffer.get();
+    double* prev = prev_buffer.get();
+    double* temp = temp_buffer.get();
+
+    Mat3D result(depth, Mat2D(rows, std::vector<double>(cols, 0.0)));
+    // 第l层网格 = 各体素按灰度线性分配到相邻两层后、再经灰度高斯核加权的空间散射，之后做空间模糊；
+    // 灰度落在[l-1, l)层间的体素在得到第l层后，由第l-1、l两层四线性插值得到结果
+    for (int l = 0; l <= levels; ++l) {
+        int b0 = std::max(0, l - pad - 1), b1 = std::min(levels, l + pad + 1);
+        bool cur_empty = start[b0] == start[b1];
+        if (!cur_empty) {
+            std::fill(cur, cur + total, 0.0);
+            for (size_t k = start[b0]; k < start[b1]; ++k) {
+                size_t i = order[k];
+                int z = i / plane, r = (i % plane) / cols, c = i % cols;
+                double v = input[z][r][c];
+                double fr = (v - vmin) / sigma_range;
+                int b = std::min(static_cast<int>(fr), levels - 1);
+                double tr = fr - b;
+                // 体素对相邻两层b、b+1的线性权重，再乘以两层到第l层的灰度核权重
+                int d0 = b - l, d1 = b + 1 - l;
+                double w = (std::abs(d0) <= pad ? (1.0 - tr) * range_kernel[d0 + pad] : 0.0) +
+                           (std::abs(d1) <= pad ? tr * range_kernel[d1 + pad] : 0.0);
+                size_t iz = static_cast<size_t>(std::lround(z / step) + pad);
+                size_t iy = static_cast<size_t>(std::lround(r / step) + pad);
+                size_t ix = static_cast<size_t>(std::lround(c / step) + pad);
+                double* g = cur + iz * sz + iy * sy + ix * sx;
+                g[0] += v * w;
+                g[1] += w;
+            }
+            // 空间三维可分离高斯模糊
+            blur_grid_axis(cur, temp, total, 1, gz, sz, kernel);
+            blur_grid_axis(cur, temp, total, gz, gy, sy, kernel);
+            blur_grid_axis(cur, temp, total, static_cast<size_t>(gz) * gy, gx, sx, kernel);
+        }
+
+        // 切片：第l-1层的体素非空时其本身也散射到了第l层，因此prev、cur均有效
+        if (l > 0) {
+            for (size_t k = start[l - 1]; k < start[l]; ++k) {
+                size_t i = order[k];
+                int z = i / plane, r = (i % plane) / cols, c = i % cols;
+                double v = input[z][r][c];
+                double tr = std::min((v - vmin) / sigma_range - (l - 1), 1.0);
+                double fz = z / step + pad, fy = r / step + pad, fx = c / step + pad;
+                size_t z0 = static_cast<size_t>(fz), y0 = static_cast<size_t>(fy), x0 = static_cast<size_t>(fx);
+                double tz = fz - z0, ty = fy - y0, tx = fx - x0;
+
+                double num = 0.0, den = 0.0;
+                for (int dz = 0; dz < 2; ++dz) {
+                    double wz = dz ? tz : 1.0 - tz;
+                    for (int dy = 0; dy < 2; ++dy) {
+                        double wy = wz * (dy ? ty : 1.0 - ty);
+                        for (int dx = 0; dx < 2; ++dx) {
+                            double wx = wy * (dx ? tx : 1.0 - tx);
+                            size_t o = (z0 + dz) * sz + (y0 + dy) * sy + (x0 + dx) * sx;
+                            double w0 = wx * (1.0 - tr);
+                            double w1 = wx * tr;
+                            num += prev[o] * w0 + cur[o] * w1;
+                            den += prev[o + 1] * w0 + cur[o + 1] * w1;
+                        }
+                    }
+                }
+                result[z][r][c] = den > 0 ? num / den : v;
+            }
+        }
+
+        std::swap(prev, cur);
+    }
+
+    return result;
+}
@@ -5,6 +5,7 @@
 #include <stdexcept>
 
 #include "ImageFilter.h"
+#include "VolumePool.h"
 
 
 bool ImageFilter::isClose(double a, double b, double eps) {
@@ -59,40 +60,26 @@ Mat2D ImageFilter::pad2D(const Mat2D& input, int pad_row, int pad_col,
         }
     }
 
-    // 填充上下边界
+    // 填充上下边界（含四角）：上下两侧分别按各自的越界索引取镜像值
     for (int i = 0; i < pad_row; ++i) {
-        int row_idx = i;                  // 上边界行索引
-        int mirror_row = pad_row - i - 1; // 镜像行索引
-
+        int top_row = i - pad_row;        // 上边界对应的原始行索引（<0）
+        int bottom_row = rows + i;        // 下边界对应的原始行索引（>=rows）
         for (int j = 0; j < new_cols; ++j) {
-            // 计算原始列索引
             int col_idx = j - pad_col;
-            int original_col = getMirrorIndex(col_idx, cols, borderType);
-
-            double val;
-            if (col_idx >= 0 && col_idx < cols) {
-                val = getBorderValue(input, mirror_row - pad_row, original_col, 
-                                    rows, cols, borderType, cval);
-            } else {
-                val = getBorderValue(input, mirror_row - pad_row, original_col, 
-                                    rows, cols, borderType, cval);
-            }
-            result[row_idx][j] = val;
-            result[new_rows - 1 - i][j] = val; // 下边界对称位置
+            result[i][j] = getBorderValue(input, top_row, col_idx, rows, cols, borderType, cval);
+            result[pad_row + rows + i][j] = getBorderValue(input, bottom_row, col_idx,
+                                                           rows, cols, borderType, cval);
         }
     }
 
     // 填充左右边界（不包括已填充的四角）
     for (int i = pad_row; i < new_rows - pad_row; ++i) {
+        int original_row = i - pad_row;
         for (int j = 0; j < pad_col; ++j) {
-            int col_idx = j;                  // 左边界列索引
-            int mirror_col = pad_col - j - 1; // 镜像列索引
-            int original_row = i - pad_row;
-
-            double val = getBorderValue(input, original_row, mirror_col - pad_col, 
-                                        rows, cols, borderType, cval);
-            result[i][col_idx] = val;
-            result[i][new_cols - 1 - j] = val; // 右边界对称位置
+            result[i][j] = getBorderValue(input, original_row, j - pad_col,
+                                          rows, cols, borderType, cval);
+            result[i][pad_col + cols + j] = getBorderValue(input, original_row, cols + j,
+                                                           rows, cols, borderType, cval);
         }
     }
 
@@ -102,6 +89,14 @@ Mat2D ImageFilter::pad2D(const Mat2D& input, int pad_row, int pad_col,
 // 3D边界填充
 Mat3D ImageFilter::pad3D(const Mat3D& input, const std::vector<int>& pads,
                     int borderType, double cval) {
+    Mat3D result = pad3D_pooled(input, pads, borderType, cval);
+    VolumePool::instance().detach(result);
+    return result;
+}
+
+// 3D边界填充（结果由缓冲池借出）
+Mat3D ImageFilter::pad3D_pooled(const Mat3D& input, const std::vector<int>& pads,
+                           int borderType, double cval) {
     if (input.empty()) return {};
     if (pads.size() < 2) throw std::invalid_argument("Pads must have at least 2 elements");
     
@@ -110,34 +105,31 @@ Mat3D ImageFilter::pad3D(const Mat3D& input, const std::vector<int>& pads,
     int pad_depth = pads.size() > 2 ? pads[2] : 0;
     int depth = input.size();
 
-    // 先处理每个2D切片的行和列填充
-    std::vector<Mat2D> sliced_padded(depth);
-    for (int z = 0; z < depth; ++z) {
-        sliced_padded[z] = pad2D(input[z], pad_row, pad_col, borderType, cval);
-    }
-
-    // 处理深度方向填充
     int new_depth = depth + 2 * pad_depth;
-    int new_rows = sliced_padded[0].size();
-    int new_cols = sliced_padded[0][0].size();
-    Mat3D result(new_depth, Mat2D(new_rows, std::vector<double>(new_cols, 0.0)));
+    int new_rows = input[0].size() + 2 * pad_row;
+    int new_cols = input[0][0].size() + 2 * pad_col;
+    // 结果的每个元素都会被写入，可直接复用缓冲池中的同尺寸体数据
+    Mat3D result = VolumePool::instance().acquire(new_depth, new_rows, new_cols);
+    PooledVolumeGuard guard(result, false);
 
-    // 复制中间原始深度切片
+    // 逐切片做行和列填充，直接写入结果的中间切片（不保留整块的中间副本）
     for (int z = 0; z < depth; ++z) {
-        result[pad_depth + z] = sliced_padded[z];
+        Mat2D slice = pad2D(input[z], pad_row, pad_col, borderType, cval);
+        for (int i = 0; i < new_rows; ++i) {
+            std::copy(slice[i].begin(), slice[i].end(), result[pad_depth + z][i].begin());
+        }
     }
 
     // 填充深度方向前半部分
     for (int z = 0; z < pad_depth; ++z) {
         int src_z = getMirrorIndex(z - pad_depth, depth, borderType);
-        src_z = std::clamp(src_z, 0, depth - 1);
         
         for (int i = 0; i < new_rows; ++i) {
             for (int j = 0; j < new_cols; ++j) {
                 if (borderType == 0) { // CONSTANT
                     result[z][i][j] = cval;
                 } else {
-                    result[z][i][j] = sliced_padded[src_z][i][j];
+                    result[z][i][j] = result[pad_depth + src_z][i][j];
                 }
             }
         }
@@ -147,19 +139,19 @@ Mat3D ImageFilter::pad3D(const Mat3D& input, const std::vector<int>& pads,
     for (int z = 0; z < pad_depth; ++z) {
         int dst_z = pad_depth + depth + z;
         int src_z = getMirrorIndex(depth + z, depth, borderType);
-        src_z = std::clamp(src_z, 0, depth - 1);
         
         for (int i = 0; i < new_rows; ++i) {
             for (int j = 0; j < new_cols; ++j) {
                 if (borderType == 0) { // CONSTANT
                     result[dst_z][i][j] = cval;
                 } else {
-                    result[dst_z][i][j] = sliced_padded[src_z][i][j];
+                    result[dst_z][i][j] = result[pad_depth + src_z][i][j];
                 }
             }
         }
     }
 
+    guard.dismiss();
     return result;
 }
 
@@ -169,6 +161,13 @@ Mat3D ImageFilter::pad3D(const Mat3D& input, const std::vector<int>& pads,
     // 1D相关运算
 void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& weights,
                         int axis, Mat3D& output, int borderType, double cval) {
+    correlate1d_pooled(input, weights, axis, output, borderType, cval);
+    VolumePool::instance().detach(output);
+}
+
+// 1D相关运算（输出由缓冲池借出）
+void ImageFilter::correlate1d_pooled(const Mat3D& input, const std::vector<double>& weights,
+                                int axis, Mat3D& output, int borderType, double cval) {
     if (input.empty() || weights.empty()) return;
     if (axis < 0 || axis > 2) throw std::invalid_argument("Invalid axis (0-2)");
 
@@ -177,19 +176,24 @@ void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& wei
     std::vector<int> pads(3, 0);
     pads[axis] = k_half;
 
-    // 边界填充
-    Mat3D padded = pad3D(input, pads, borderType, cval);
+    // 边界填充：计入缓冲池借出量，各轴填充后的尺寸不会再被请求，用毕直接释放而不缓存
+    Mat3D padded = pad3D_pooled(input, pads, borderType, cval);
+    PooledVolumeGuard padded_guard(padded, false);
 
-    // 初始化输出
+    // 初始化输出（每个元素都会被写入：尺寸已符合时直接复用，否则从缓冲池借出）
     int depth = input.size();
     int rows = input[0].size();
     int cols = input[0][0].size();
-    output = Mat3D(depth, Mat2D(rows, std::vector<double>(cols, 0.0)));
+    if (static_cast<int>(output.size()) != depth || output[0].size() != static_cast<size_t>(rows) ||
+        output[0][0].size() != static_cast<size_t>(cols)) {
+        VolumePool::instance().release(std::move(output));
+        output = VolumePool::instance().acquire(depth, rows, cols);
+    }
 
-    // 判断核对称性
-    bool symmetric = true;
-    bool anti_symmetric = true;
-    for (int i = 1; i <= k_half; ++i) {
+    // 判断核对称性（仅奇数长度的核存在中心抽头）
+    bool symmetric = ksize % 2 == 1;
+    bool anti_symmetric = ksize % 2 == 1;
+    for (int i = 1; i <= k_half && (symmetric || anti_symmetric); ++i) {
         if (!isClose(weights[k_half + i], weights[k_half - i])) symmetric = false;
         if (!isClose(weights[k_half + i], -weights[k_half - i])) anti_symmetric = false;
     }
@@ -210,8 +214,8 @@ void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& wei
                     } else if (anti_symmetric) {
                         sum = padded[z + pads[2]][center_y][c + pads[1]] * weights[k_half];
                         for (int i = 1; i <= k_half; ++i) {
-                            sum += (padded[z + pads[2]][center_y - i][c + pads[1]] -
-                                    padded[z + pads[2]][center_y + i][c + pads[1]]) * weights[k_half + i];
+                            sum += (padded[z + pads[2]][center_y + i][c + pads[1]] -
+                                    padded[z + pads[2]][center_y - i][c + pads[1]]) * weights[k_half + i];
                         }
                     } else {
                         for (int i = 0; i < ksize; ++i) {
@@ -239,8 +243,8 @@ void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& wei
                     } else if (anti_symmetric) {
                         sum = padded[z + pads[2]][r + pads[0]][center_x] * weights[k_half];
                         for (int i = 1; i <= k_half; ++i) {
-                            sum += (padded[z + pads[2]][r + pads[0]][center_x - i] -
-                                    padded[z + pads[2]][r + pads[0]][center_x + i]) * weights[k_half + i];
+                            sum += (padded[z + pads[2]][r + pads[0]][center_x + i] -
+                                    padded[z + pads[2]][r + pads[0]][center_x - i]) * weights[k_half + i];
                         }
                     } else {
                         for (int i = 0; i < ksize; ++i) {
@@ -268,8 +272,8 @@ void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& wei
                     } else if (anti_symmetric) {
                         sum = padded[center_z][r + pads[0]][c + pads[1]] * weights[k_half];
                         for (int i = 1; i <= k_half; ++i) {
-                            sum += (padded[center_z - i][r + pads[0]][c + pads[1]] -
-                                    padded[center_z + i][r + pads[0]][c + pads[1]]) * weights[k_half + i];
+                            sum += (padded[center_z + i][r + pads[0]][c + pads[1]] -
+                                    padded[center_z - i][r + pads[0]][c + pads[1]]) * weights[k_half + i];
                         }
                     } else {
                         for (int i = 0; i < ksize; ++i) {
@@ -282,6 +286,7 @@ void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& wei
             }
         }
     }
+
 }
 
 
@@ -297,9 +302,7 @@ void ImageFilter::correlate1d(const Mat3D& input, const std::vector<double>& wei
 // 1D高斯滤波
 void ImageFilter::gaussian_filter1d(const Mat3D& input, double sigma, int axis,
                                 Mat3D& output, int borderType, double cval) {
-    int radius = static_cast<int>(4 * sigma + 0.5);
-    auto kernel = gaussian_kernel1d(sigma, radius);
-    std::reverse(kernel.begin(), kernel.end()); // 卷积需要核反转
+    auto kernel = getGaussianWeights(sigma);
     correlate1d(input, kernel, axis, output, borderType, cval);
 }
 
@@ -307,15 +310,19 @@ void ImageFilter::gaussian_filter1d(const Mat3D& input, double sigma, int axis,
 Mat3D ImageFilter::gaussian_filter(const Mat3D& input, double sigma, 
                             int borderType, double cval) {
     if (input.empty()) return {};
-    Mat3D result = input;
-    int dims = 3; // 假设3D数据
-
-    for (int axis = 0; axis < dims; ++axis) {
-        Mat3D temp;
-        gaussian_filter1d(result, sigma, axis, temp, borderType, cval);
-        result = temp;
+    auto kernel = getGaussianWeights(sigma);
+
+    // result与temp在各轴间交替复用，均由缓冲池借出；result返回前移交给调用者，temp归还缓存
+    Mat3D result, temp;
+    PooledVolumeGuard result_guard(result), temp_guard(temp);
+    correlate1d_pooled(input, kernel, 0, result, borderType, cval);
+    for (int axis = 1; axis < 3; ++axis) {
+        correlate1d_pooled(result, kernel, axis, temp, borderType, cval);
+        result.swap(temp);
     }
 
+    VolumePool::instance().detach(result);
+    result_guard.dismiss();
     return result;
 }
 
@@ -336,19 +343,22 @@ Mat3D ImageFilter::sobel(const Mat3D& input, int axis,
 
     // 梯度核
     std::vector<double> grad_kernel = {-1, 0, 1};
-    Mat3D result;
-    correlate1d(input, grad_kernel, axis, result, borderType, cval);
+    Mat3D result, temp;
+    PooledVolumeGuard result_guard(result), temp_guard(temp);
+    correlate1d_pooled(input, grad_kernel, axis, result, borderType, cval);
 
-    // 平滑核
+    // 平滑核：与scipy.ndimage.sobel的轴顺序（深度、行、列）一致，CONSTANT边界下结果才相同
     std::vector<double> smooth_kernel = {1, 2, 1};
-    for (int ax = 0; ax < 3; ++ax) {
+    const int order[3] = {2, 0, 1};
+    for (int ax : order) {
         if (ax != axis) {
-            Mat3D temp;
-            correlate1d(result, smooth_kernel, ax, temp, borderType, cval);
-            result = temp;
+            correlate1d_pooled(result, smooth_kernel, ax, temp, borderType, cval);
+            result.swap(temp);
         }
     }
 
+    VolumePool::instance().detach(result);
+    result_guard.dismiss();
     return result;
 }
 
@@ -362,19 +372,46 @@ int ImageFilter::getMirrorIndex(int idx, int size, int borderType) {
     switch (borderType) {
         case 1:  // REPLICATE
             return std::clamp(idx, 0, size - 1);
-        case 2:  // REFLECT
-            if (idx < 0) return -idx - 1;
-            if (idx >= size) return 2 * size - idx - 1;
-            return idx;
-        case 3:  // REFLECT_101
-            if (idx < 0) return -idx;
-            if (idx >= size) return 2 * size - idx - 2;
-            return idx;
+        // 镜像按周期折返：填充宽度超过维度大小时与scipy.ndimage一致
+        case 2: {  // REFLECT，周期2*size
+            int period = 2 * size;
+            int m = idx % period;
+            if (m < 0) m += period;
+            return m < size ? m : period - 1 - m;
+        }
+        case 3: {  // REFLECT_101，周期2*size-2
+            if (size == 1) return 0;
+            int period = 2 * size - 2;
+            int m = idx % period;
+            if (m < 0) m += period;
+            return m < size ? m : period - m;
+        }
         default: // CONSTANT
             return 0;
     }
 }
 
+// 填充后一条线的源索引表
+std::vector<int> ImageFilter::getSourceIndexTable(int size, int before, int after, int borderType) {
+    std::vector<int> index(std::max(0, before + size + after));
+    for (int p = 0; p < static_cast<int>(index.size()); ++p) {
+        int idx = p - before;
+        if (idx < 0 || idx >= size) {
+            idx = borderType == 0 ? -1 : getMirrorIndex(idx, size, borderType);
+        }
+        index[p] = idx;
+    }
+    return index;
+}
+
+// 高斯相关核
+std::vector<double> ImageFilter::getGaussianWeights(double sigma) {
+    int radius = static_cast<int>(4 * sigma + 0.5);
+    auto kernel = gaussian_kernel1d(sigma, radius);
+    std::reverse(kernel.begin(), kernel.end()); // 卷积需要核反转
+    return kernel;
+}
+
 // 获取边界填充值
 double ImageFilter::getBorderValue(const Mat2D& input, int row, int col,
                             int rows, int cols, int borderType, double cval) {
@@ -386,9 +423,7 @@ double ImageFilter::getBorderValue(const Mat2D& input, int row, int col,
         return cval;
     }
 
-    int r = getMirrorIndex(row, rows, borderType);
-    int c = getMirrorIndex(col, cols, borderType);
-    return input[r][c];
+    return input[getMirrorIndex(row, rows, borderType)][getMirrorIndex(col, cols, borderType)];
 }
 
 
@@ -0,0 +1,153 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "ImageFilter.h"
+
+
+Mat3DI ImageFilter::to_int_volume(const Mat3D& input) {
+    Mat3DI result(input.size());
+    for (size_t z = 0; z < input.size(); ++z) {
+        result[z].resize(input[z].size());
+        for (size_t r = 0; r < input[z].size(); ++r) {
+            result[z][r].resize(input[z][r].size());
+            for (size_t c = 0; c < input[z][r].size(); ++c) {
+                result[z][r][c] = static_cast<int32_t>(std::lround(input[z][r][c]));
+            }
+        }
+    }
+    return result;
+}
+
+Mat3D ImageFilter::to_double_volume(const Mat3DI& input, double scale) {
+    Mat3D result(input.size());
+    for (size_t z = 0; z < input.size(); ++z) {
+        result[z].resize(input[z].size());
+        for (size_t r = 0; r < input[z].size(); ++r) {
+            result[z][r].resize(input[z][r].size());
+            for (size_t c = 0; c < input[z][r].size(); ++c) {
+                result[z][r][c] = input[z][r][c] * scale;
+            }
+        }
+    }
+    return result;
+}
+
+// 定点量化：逐元素四舍五入，残差补到中心元素使总和为2^frac_bits
+std::vector<int> ImageFilter::quantize_kernel(const std::vector<double>& weights, int frac_bits) {
+    std::vector<int> q(weights.size());
+    double one = std::ldexp(1.0, frac_bits);
+    long long sum = 0;
+    double fsum = 0.0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        q[i] = static_cast<int>(std::lround(weights[i] * one));
+        sum += q[i];
+        fsum += weights[i];
+    }
+    if (!q.empty()) {
+        q[q.size() / 2] += static_cast<int>(std::llround(fsum * one) - sum);
+    }
+    return q;
+}
+
+// 整数1D相关：对每条输出行按核元素累加整行，内层循环连续且无分支
+void ImageFilter::correlate1d_int(const Mat3DI& input, const std::vector<int>& weights,
+                                  int axis, Mat3DI& output, int shift,
+                                  int borderType, int32_t cval) {
+    if (input.empty() || weights.empty()) return;
+    if (axis < 0 || axis > 2) throw std::invalid_argument("Invalid axis (0-2)");
+    if (shift < 0) throw std::invalid_argument("Shift must be >= 0");
+
+    int ksize = weights.size();
+    int k_half = ksize / 2;
+    int depth = input.size();
+    int rows = input[0].size();
+    int cols = input[0][0].size();
+    const int32_t round = shift > 0 ? (1 << (shift - 1)) : 0;
+
+    // 该轴填充后的源索引表（-1表示CONSTANT填充）
+    int sizes[3] = {rows, cols, depth};
+    std::vector<int> index = getSourceIndexTable(sizes[axis], k_half, k_half, borderType);
+
+    output = Mat3DI(depth, std::vector<std::vector<int32_t>>(rows, std::vector<int32_t>(cols, 0)));
+    std::vector<int32_t> const_row(cols, cval);
+    std::vector<int32_t> acc(cols);
+
+    auto store = [&](std::vector<int32_t>& dst) {
+        for (int c = 0; c < cols; ++c) dst[c] = (acc[c] + round) >> shift;
+    };
+
+    if (axis == 0 || axis == 2) {  // 行/深度方向：源为其他行，整行累加
+        for (int z = 0; z < depth; ++z) {
+            for (int r = 0; r < rows; ++r) {
+                int pos = axis == 0 ? r : z;
+                std::fill(acc.begin(), acc.end(), 0);
+                for (int k = 0; k < ksize; ++k) {
+                    int32_t w = weights[k];
+                    if (w == 0) continue;
+                    int src = index[pos + k];
+                    const int32_t* row = src < 0 ? const_row.data()
+                                       : (axis == 0 ? input[z][src].data() : input[src][r].data());
+                    for (int c = 0; c < cols; ++c) acc[c] += w * row[c];
+                }
+                store(output[z][r]);
+            }
+        }
+    } else {  // 列方向：先构造填充行，再按核元素平移累加
+        std::vector<int32_t> buf(cols + 2 * k_half);
+        for (int z = 0; z < depth; ++z) {
+            for (int r = 0; r < rows; ++r) {
+                const std::vector<int32_t>& row = input[z][r];
+                for (int i = 0; i < cols + 2 * k_half; ++i) {
+                    int src = index[i];
+                    buf[i] = src < 0 ? cval : row[src];
+                }
+                std::fill(acc.begin(), acc.end(), 0);
+                for (int k = 0; k < ksize; ++k) {
+                    int32_t w = weights[k];
+                    if (w == 0) continue;
+                    const int32_t* b = buf.data() + k;
+                    for (int c = 0; c < cols; ++c) acc[c] += w * b[c];
+                }
+                store(output[z][r]);
+            }
+        }
+    }
+}
+
+// 定点高斯滤波
+Mat3DI ImageFilter::gaussian_filter_int(const Mat3DI& input, double sigma, int frac_bits,
+                                        int borderType, int32_t cval) {
+    if (input.empty()) return {};
+    auto kernel = getGaussianWeights(sigma);
+    std::vector<int> qkernel = quantize_kernel(kernel, frac_bits);
+
+    Mat3DI result = input;
+    for (int axis = 0; axis < 3; ++axis) {
+        Mat3DI temp;
+        correlate1d_int(result, qkernel, axis, temp, frac_bits, borderType, cval);
+        result = std::move(temp);
+    }
+    return result;
+}
+
+// 整数Sobel滤波
+Mat3DI ImageFilter::sobel_int(const Mat3DI& input, int axis, int borderType, int32_t cval) {
+    if (input.empty()) return {};
+    if (axis < 0 || axis > 2) throw std::invalid_argument("Invalid axis (0-2)");
+
+    Mat3DI result;
+    correlate1d_int(input, {-1, 0, 1}, axis, result, 0, borderType, cval);
+
+    // 与scipy.ndimage.sobel的轴顺序（深度、行、列）一致，CONSTANT边界下结果才相同
+    const int order[3] = {2, 0, 1};
+    for (int ax : order) {
+        if (ax != axis) {
+            Mat3DI temp;
+            correlate1d_int(result, {1, 2, 1}, ax, temp, 0, borderType, cval);
+            result = std::move(temp);
+        }
+    }
+    return result;
+}
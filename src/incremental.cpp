@@ -0,0 +1,107 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "ImageFilter.h"
+
+
+// 合并重叠或相邻的左闭右开区间
+static std::vector<std::pair<int, int>> merge_ranges(std::vector<std::pair<int, int>> ranges) {
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<std::pair<int, int>> merged;
+    for (const auto& rg : ranges) {
+        if (rg.first >= rg.second) continue;
+        if (!merged.empty() && rg.first <= merged.back().second) {
+            merged.back().second = std::max(merged.back().second, rg.second);
+        } else {
+            merged.push_back(rg);
+        }
+    }
+    return merged;
+}
+
+// 缓存行、列两轴中间结果的高斯滤波
+Mat3D ImageFilter::gaussian_filter_cached(const Mat3D& input, double sigma, GaussianCache& cache,
+                                          int borderType, double cval) {
+    cache.sigma = sigma;
+    cache.borderType = borderType;
+    cache.cval = cval;
+    cache.inplane.clear();
+    if (input.empty()) return {};
+
+    Mat3D temp;
+    gaussian_filter1d(input, sigma, 0, temp, borderType, cval);
+    gaussian_filter1d(temp, sigma, 1, cache.inplane, borderType, cval);
+
+    Mat3D result;
+    gaussian_filter1d(cache.inplane, sigma, 2, result, borderType, cval);
+    return result;
+}
+
+// 增量更新：只重做修改切片的平面内滤波和受影响切片的深度方向滤波
+void ImageFilter::gaussian_filter_update(const Mat3D& input,
+                                         const std::vector<std::pair<int, int>>& dirty,
+                                         GaussianCache& cache, Mat3D& output) {
+    if (input.empty()) return;
+    int depth = input.size();
+    int rows = input[0].size();
+    int cols = input[0][0].size();
+    if (static_cast<int>(cache.inplane.size()) != depth || static_cast<int>(output.size()) != depth ||
+        static_cast<int>(cache.inplane[0].size()) != rows || static_cast<int>(cache.inplane[0][0].size()) != cols) {
+        throw std::invalid_argument("Input size does not match the cached result");
+    }
+    for (const auto& rg : dirty) {
+        if (rg.first < 0 || rg.second > depth) throw std::out_of_range("Dirty slice range out of range");
+    }
+
+    double sigma = cache.sigma;
+    int borderType = cache.borderType;
+    double cval = cache.cval;
+    auto kernel = getGaussianWeights(sigma);
+    int radius = kernel.size() / 2;
+
+    // 1. 修改切片重新做行、列两轴滤波（各切片互不影响）
+    std::vector<std::pair<int, int>> changed = merge_ranges(dirty);
+    for (const auto& rg : changed) {
+        Mat3D slab(input.begin() + rg.first, input.begin() + rg.second);
+        Mat3D temp, inplane;
+        gaussian_filter1d(slab, sigma, 0, temp, borderType, cval);
+        gaussian_filter1d(temp, sigma, 1, inplane, borderType, cval);
+        std::move(inplane.begin(), inplane.end(), cache.inplane.begin() + rg.first);
+    }
+
+    // 2. 受影响的输出切片：修改范围向两侧扩展一个核半径
+    //    （镜像/复制边界下的越界引用也都落在此范围内）
+    std::vector<std::pair<int, int>> affected;
+    for (const auto& rg : changed) {
+        affected.push_back({std::max(0, rg.first - radius), std::min(depth, rg.second + radius)});
+    }
+    affected = merge_ranges(affected);
+
+    // 3. 深度方向重算，求和顺序与correlate1d的对称核分支一致，结果逐位相同
+    const Mat3D& src = cache.inplane;
+    std::vector<double> const_row(cols, cval);
+    std::vector<int> index = getSourceIndexTable(depth, radius, radius, borderType);
+    auto slice_row = [&](int z, int r) -> const std::vector<double>& {
+        int s = index[z + radius];
+        return s < 0 ? const_row : src[s][r];
+    };
+
+    for (const auto& rg : affected) {
+        for (int z = rg.first; z < rg.second; ++z) {
+            for (int r = 0; r < rows; ++r) {
+                std::vector<double>& dst = output[z][r];
+                const std::vector<double>& center = src[z][r];
+                double wc = kernel[radius];
+                for (int c = 0; c < cols; ++c) dst[c] = center[c] * wc;
+                for (int i = 1; i <= radius; ++i) {
+                    const std::vector<double>& lo = slice_row(z - i, r);
+                    const std::vector<double>& hi = slice_row(z + i, r);
+                    double w = kernel[radius + i];
+                    for (int c = 0; c < cols; ++c) dst[c] += (lo[c] + hi[c]) * w;
+                }
+            }
+        }
+    }
+}
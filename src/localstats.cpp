@@ -0,0 +1,237 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <functional>
+
+#include "ImageFilter.h"
+
+
+// 取出3D矩阵沿axis的一条线（a、b为另外两个维度的索引，次序同下方循环）
+static void gather_line(const Mat3D& m, int axis, int a, int b, std::vector<double>& line) {
+    int n = line.size();
+    if (axis == 0) {
+        for (int i = 0; i < n; ++i) line[i] = m[a][i][b];
+    } else if (axis == 1) {
+        std::copy(m[a][b].begin(), m[a][b].end(), line.begin());
+    } else {
+        for (int i = 0; i < n; ++i) line[i] = m[i][a][b];
+    }
+}
+
+static void scatter_line(Mat3D& m, int axis, int a, int b, const std::vector<double>& line) {
+    int n = line.size();
+    if (axis == 0) {
+        for (int i = 0; i < n; ++i) m[a][i][b] = line[i];
+    } else if (axis == 1) {
+        std::copy(line.begin(), line.end(), m[a][b].begin());
+    } else {
+        for (int i = 0; i < n; ++i) m[i][a][b] = line[i];
+    }
+}
+
+// 按预先计算的索引表填充一条线（-1表示CONSTANT填充值）
+static void fill_padded(const std::vector<double>& line, const std::vector<int>& index,
+                        double pad_value, std::vector<double>& buf) {
+    for (size_t i = 0; i < index.size(); ++i) {
+        buf[i] = index[i] < 0 ? pad_value : line[index[i]];
+    }
+}
+
+// Kahan补偿累加
+static inline void kahan_add(double& sum, double& comp, double v) {
+    double y = v - comp;
+    double t = sum + y;
+    comp = (t - sum) - y;
+    sum = t;
+}
+
+// 滑动窗口均值：buf长度为n+w-1，out[i] = mean(buf[i .. i+w-1])
+static void running_mean(const std::vector<double>& buf, int w, bool stable,
+                         std::vector<double>& out) {
+    int n = out.size();
+    double sum = 0.0, comp = 0.0;
+    if (stable) {
+        for (int k = 0; k < w; ++k) kahan_add(sum, comp, buf[k]);
+        out[0] = sum / w;
+        for (int i = 1; i < n; ++i) {
+            kahan_add(sum, comp, buf[i + w - 1]);
+            kahan_add(sum, comp, -buf[i - 1]);
+            out[i] = sum / w;
+        }
+    } else {
+        for (int k = 0; k < w; ++k) sum += buf[k];
+        out[0] = sum / w;
+        for (int i = 1; i < n; ++i) {
+            sum += buf[i + w - 1] - buf[i - 1];
+            out[i] = sum / w;
+        }
+    }
+}
+
+// van Herk/Gil-Werman滑动最小/最大值：每个元素约3次比较，与窗口大小无关
+template <typename Cmp>
+static void running_extreme(const std::vector<double>& buf, int w, Cmp better,
+                            std::vector<double>& g, std::vector<double>& h,
+                            std::vector<double>& out) {
+    int len = buf.size();
+    for (int i = 0; i < len; ++i) {
+        g[i] = (i % w == 0) ? buf[i] : (better(buf[i], g[i - 1]) ? buf[i] : g[i - 1]);
+    }
+    for (int i = len - 1; i >= 0; --i) {
+        h[i] = (i == len - 1 || (i + 1) % w == 0) ? buf[i] : (better(buf[i], h[i + 1]) ? buf[i] : h[i + 1]);
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        double a = h[i], b = g[i + w - 1];
+        out[i] = better(a, b) ? a : b;
+    }
+}
+
+// 局部统计量：三个轴依次做融合的x / x²滑动均值（可选最小/最大值）
+LocalStats ImageFilter::local_statistics(const Mat3D& input, const std::vector<int>& size,
+                                         bool with_minmax, bool stable,
+                                         int borderType, double cval) {
+    if (size.size() < 3) throw std::invalid_argument("Window size must have 3 elements");
+    for (int w : size) {
+        if (w < 1) throw std::invalid_argument("Window size must be >= 1");
+    }
+    LocalStats stats;
+    if (input.empty()) return stats;
+
+    int depth = input.size();
+    int rows = input[0].size();
+    int cols = input[0][0].size();
+    int dims[3] = {rows, cols, depth};
+
+    // 稳定模式下先减去全局均值，减小E[x²]-E[x]²的相消误差
+    double shift = 0.0;
+    if (stable) {
+        double sum = 0.0, comp = 0.0;
+        for (const auto& slice : input)
+            for (const auto& row : slice)
+                for (double v : row) kahan_add(sum, comp, v);
+        shift = sum / (static_cast<double>(depth) * rows * cols);
+    }
+
+    Mat3D s1 = input;
+    Mat3D s2 = input;
+    for (int z = 0; z < depth; ++z) {
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                double v = input[z][r][c] - shift;
+                s1[z][r][c] = v;
+                s2[z][r][c] = v * v;
+            }
+        }
+    }
+    if (with_minmax) {
+        stats.min = input;
+        stats.max = input;
+    }
+    double pad1 = cval - shift;
+    double pad2 = pad1 * pad1;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        int w = size[axis];
+        if (w == 1) continue;
+        int n = dims[axis];
+        int left = w / 2;
+
+        // 该轴填充后的索引表
+        std::vector<int> index = getSourceIndexTable(n, left, w - 1 - left, borderType);
+
+        // 另外两个维度的循环范围
+        int outer_a = axis == 2 ? rows : depth;
+        int outer_b = axis == 0 ? cols : (axis == 1 ? rows : cols);
+
+        std::vector<double> line(n), buf(n + w - 1), out(n);
+        std::vector<double> g(n + w - 1), h(n + w - 1);
+        for (int a = 0; a < outer_a; ++a) {
+            for (int b = 0; b < outer_b; ++b) {
+                gather_line(s1, axis, a, b, line);
+                fill_padded(line, index, pad1, buf);
+                running_mean(buf, w, stable, out);
+                scatter_line(s1, axis, a, b, out);
+
+                gather_line(s2, axis, a, b, line);
+                fill_padded(line, index, pad2, buf);
+                running_mean(buf, w, stable, out);
+                scatter_line(s2, axis, a, b, out);
+
+                if (with_minmax) {
+                    gather_line(stats.min, axis, a, b, line);
+                    fill_padded(line, index, cval, buf);
+                    running_extreme(buf, w, std::less<double>(), g, h, out);
+                    scatter_line(stats.min, axis, a, b, out);
+
+                    gather_line(stats.max, axis, a, b, line);
+                    fill_padded(line, index, cval, buf);
+                    running_extreme(buf, w, std::greater<double>(), g, h, out);
+                    scatter_line(stats.max, axis, a, b, out);
+                }
+            }
+        }
+    }
+
+    // s1、s2此时分别为E[x-shift]与E[(x-shift)²]
+    for (int z = 0; z < depth; ++z) {
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                double m = s1[z][r][c];
+                s2[z][r][c] = std::max(0.0, s2[z][r][c] - m * m);
+                s1[z][r][c] = m + shift;
+            }
+        }
+    }
+    stats.mean = std::move(s1);
+    stats.variance = std::move(s2);
+    return stats;
+}
+
+// 自适应Wiener滤波
+Mat3D ImageFilter::wiener_filter(const Mat3D& input, const std::vector<int>& size,
+                                 double noise, int borderType, double cval) {
+    if (input.empty()) return {};
+    LocalStats stats = local_statistics(input, size, false, true, borderType, cval);
+
+    if (noise < 0) {
+        double sum = 0.0;
+        size_t count = 0;
+        for (const auto& slice : stats.variance)
+            for (const auto& row : slice)
+                for (double v : row) { sum += v; ++count; }
+        noise = sum / count;
+    }
+
+    Mat3D result = std::move(stats.mean);
+    for (size_t z = 0; z < result.size(); ++z) {
+        for (size_t r = 0; r < result[z].size(); ++r) {
+            for (size_t c = 0; c < result[z][r].size(); ++c) {
+                double var = stats.variance[z][r][c];
+                if (var > noise) {
+                    double m = result[z][r][c];
+                    result[z][r][c] = m + (1.0 - noise / var) * (input[z][r][c] - m);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+// 局部对比度归一化
+Mat3D ImageFilter::local_contrast_normalize(const Mat3D& input, const std::vector<int>& size,
+                                            double eps, int borderType, double cval) {
+    if (input.empty()) return {};
+    LocalStats stats = local_statistics(input, size, false, true, borderType, cval);
+
+    Mat3D result = input;
+    for (size_t z = 0; z < result.size(); ++z) {
+        for (size_t r = 0; r < result[z].size(); ++r) {
+            for (size_t c = 0; c < result[z][r].size(); ++c) {
+                result[z][r][c] = (input[z][r][c] - stats.mean[z][r][c]) /
+                                  std::sqrt(stats.variance[z][r][c] + eps);
+            }
+        }
+    }
+    return result;
+}
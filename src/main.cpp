@@ -7,8 +7,10 @@
 #include <cstdint>
 #include <cmath>
 #include <cstddef>
+#include <chrono>
 
 #include "ImageFilter.h"  // 你的滤波类头文件
+#include "VolumePool.h"
 
 // ITK库包含（严格适配ITK 5.4）
 #include "itkImage.h"
@@ -65,7 +67,9 @@ std::vector<std::string> get_all_dcm_files(const std::string& folder_path) {
 void read_dcm_series(const std::string& folder_path, Mat3D& volume, 
                     std::vector<double>& spacing, 
                     // 元数据类型：适配ITK 5.4的返回值（const std::vector<MetaDataDictionary*>*）
-                    std::vector<itk::MetaDataDictionary*>& metaDictionaries) {
+                    std::vector<itk::MetaDataDictionary*>& metaDictionaries,
+                    // NUMA模式：按滤波时的z切片块划分并行分配并写入体数据
+                    bool numa_first_touch = false) {
     // 创建读取器和IO对象
     auto reader = ReaderType::New();
     auto dicomIO = ImageIOType::New();
@@ -110,19 +114,35 @@ void read_dcm_series(const std::string& folder_path, Mat3D& volume,
         metaDictionaries.push_back(const_cast<itk::MetaDataDictionary*>(dictPtr));
     }
 
-    // 转换为Mat3D格式（保持不变）
-    volume.resize(size[2]);
-    ImageType::IndexType index;
-
-    for (size_t z = 0; z < size[2]; ++z) {
-        volume[z].resize(size[1], std::vector<double>(size[0]));
-        index[2] = z;
-        
-        for (size_t y = 0; y < size[1]; ++y) {
-            index[1] = y;
-            for (size_t x = 0; x < size[0]; ++x) {
-                index[0] = x;
-                volume[z][y][x] = static_cast<double>(image->GetPixel(index));
+    // 转换为Mat3D格式
+    if (numa_first_touch) {
+        volume = ImageFilter::first_touch_volume(static_cast<int>(size[2]), static_cast<int>(size[1]),
+                                                 static_cast<int>(size[0]));
+        const PixelType* buffer = image->GetBufferPointer();
+        ImageFilter::parallel_for_slabs(static_cast<int>(size[2]), [&](int z0, int z1) {
+            for (int z = z0; z < z1; ++z) {
+                const PixelType* slice = buffer + static_cast<size_t>(z) * size[1] * size[0];
+                for (size_t y = 0; y < size[1]; ++y) {
+                    for (size_t x = 0; x < size[0]; ++x) {
+                        volume[z][y][x] = static_cast<double>(slice[y * size[0] + x]);
+                    }
+                }
+            }
+        });
+    } else {
+        volume.resize(size[2]);
+        ImageType::IndexType index;
+
+        for (size_t z = 0; z < size[2]; ++z) {
+            volume[z].resize(size[1], std::vector<double>(size[0]));
+            index[2] = z;
+
+            for (size_t y = 0; y < size[1]; ++y) {
+                index[1] = y;
+                for (size_t x = 0; x < size[0]; ++x) {
+                    index[0] = x;
+                    volume[z][y][x] = static_cast<double>(image->GetPixel(index));
+                }
             }
         }
     }
@@ -227,6 +247,37 @@ void save_mat3d_to_dcm(const Mat3D& mat3d, const std::string& output_folder,
     std::cout << "所有DCM文件保存完成！共 " << depth << " 个文件，输出路径：" << output_folder << std::endl;
 }
 
+// 4. NUMA基准测试：比较单线程首次写入（数据集中在一个节点，其余节点远程访问）
+//    与按切片块并行首次写入（各线程访问本地节点）两种情况下的滤波吞吐量
+void run_numa_benchmark(const Mat3D& input_vol, double sigma, int border_type) {
+    const int depth = input_vol.size();
+    const int rows = input_vol[0].size();
+    const int cols = input_vol[0][0].size();
+    const double mvox = static_cast<double>(depth) * rows * cols / 1e6;
+
+    auto time_filter = [&](const Mat3D& vol) {
+        auto t0 = std::chrono::steady_clock::now();
+        Mat3D out = ImageFilter::gaussian_filter_numa(vol, sigma, border_type);
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(t1 - t0).count();
+    };
+
+    // 主线程首次写入
+    Mat3D remote_vol = input_vol;
+    double remote_s = time_filter(remote_vol);
+
+    // 按滤波划分并行首次写入
+    Mat3D local_vol = ImageFilter::first_touch_volume(depth, rows, cols);
+    ImageFilter::parallel_for_slabs(depth, [&](int z0, int z1) {
+        for (int z = z0; z < z1; ++z) local_vol[z] = input_vol[z];
+    });
+    double local_s = time_filter(local_vol);
+
+    std::cout << "NUMA节点数：" << ImageFilter::numa_node_count() << std::endl;
+    std::cout << "单线程首次写入（远程）：" << remote_s << " s，" << mvox / remote_s << " Mvox/s" << std::endl;
+    std::cout << "并行首次写入（本地）：" << local_s << " s，" << mvox / local_s << " Mvox/s" << std::endl;
+}
+
 // -------------------------- 主函数（适配ITK 5.4） --------------------------
 int main(int argc, char* argv[]) {
     (void)argc;
@@ -240,6 +291,21 @@ int main(int argc, char* argv[]) {
         const int border_type = 1;
         const bool use_gaussian_filter = true;
         const bool use_sobel_filter = false;
+        const bool use_wiener_filter = false;
+        const std::vector<int> wiener_size = {5, 5, 3};  // [行, 列, 深度]
+        const bool use_bilateral_filter = false;
+        const double bilateral_sigma_spatial = 2.0;
+        const double bilateral_sigma_range = 80.0;       // 灰度单位（CT为HU）
+        const bool use_numa = false;          // 多路服务器：并行首次写入 + 绑核滤波
+        const bool run_numa_bench = false;
+        const size_t pool_limit_mb = 8192;    // 体数据缓冲池内存上限（0表示不限且不缓存），约为512²×600体数据的6倍
+        const bool pool_block_on_limit = false;
+        const bool use_integer_path = false;  // 16位CT可走整数/定点卷积路径
+        const bool use_gaussian_pyramid = false;
+        const int pyramid_levels = 4;       // 原始分辨率 + 2×、4×、8×
+        const double pyramid_sigma = 1.0;
+
+        VolumePool::instance().set_limit(pool_limit_mb << 20, pool_block_on_limit);
 
         // 读取DCM文件路径（保持不变）
         std::cout << "===== 开始读取DCM文件 =====" << std::endl;
@@ -252,7 +318,7 @@ int main(int argc, char* argv[]) {
         std::vector<double> spacing;
         std::vector<itk::MetaDataDictionary*> metaDictionaries;  // ITK 5.4适配类型
         
-        read_dcm_series(dcm_folder, input_vol, spacing, metaDictionaries);
+        read_dcm_series(dcm_folder, input_vol, spacing, metaDictionaries, use_numa);
         
         const size_t depth = input_vol.size();
         const size_t height = input_vol[0].size();
@@ -260,21 +326,67 @@ int main(int argc, char* argv[]) {
         std::cout << "3D体数据尺寸：z=" << depth << " × y=" << height << " × x=" << width << std::endl;
         std::cout << "像素间距：x=" << spacing[0] << "mm, y=" << spacing[1] << "mm, z=" << spacing[2] << "mm" << std::endl;
 
+        if (run_numa_bench) {
+            std::cout << "\n===== NUMA基准测试 =====" << std::endl;
+            run_numa_benchmark(input_vol, gaussian_sigma, border_type);
+            VolumePool::instance().trim();
+        }
+
+        // 多分辨率金字塔（供由粗到精的配准/螺钉检测使用）
+        if (use_gaussian_pyramid) {
+            std::cout << "\n===== 构建高斯金字塔 =====" << std::endl;
+            std::vector<PyramidLevel> pyramid =
+                ImageFilter::gaussian_pyramid(input_vol, spacing, pyramid_levels, pyramid_sigma, border_type);
+            for (size_t l = 0; l < pyramid.size(); ++l) {
+                const Mat3D& lv = pyramid[l].data;
+                std::cout << "第" << l << "层：z=" << lv.size() << " × y=" << lv[0].size() << " × x=" << lv[0][0].size()
+                          << "，间距：x=" << pyramid[l].spacing[0] << "mm, y=" << pyramid[l].spacing[1]
+                          << "mm, z=" << pyramid[l].spacing[2] << "mm" << std::endl;
+            }
+            VolumePool::instance().trim();  // 各阶段结束后释放缓存的临时体数据
+        }
+
         // 滤波处理（保持不变）
         std::cout << "\n===== 开始滤波处理 =====" << std::endl;
         Mat3D filtered_vol;
         if (use_gaussian_filter) {
             std::cout << "执行高斯滤波（sigma=" << gaussian_sigma << "）..." << std::endl;
-            filtered_vol = ImageFilter::gaussian_filter(input_vol, gaussian_sigma, border_type);
+            if (use_integer_path) {
+                filtered_vol = ImageFilter::to_double_volume(ImageFilter::gaussian_filter_int(
+                    ImageFilter::to_int_volume(input_vol), gaussian_sigma, 14, border_type));
+            } else if (use_numa) {
+                filtered_vol = ImageFilter::gaussian_filter_numa(input_vol, gaussian_sigma, border_type);
+            } else {
+                filtered_vol = ImageFilter::gaussian_filter(input_vol, gaussian_sigma, border_type);
+            }
         } else if (use_sobel_filter) {
             const int sobel_axis = 2;
             std::cout << "执行Sobel滤波（轴=" << sobel_axis << "）..." << std::endl;
-            filtered_vol = ImageFilter::sobel(input_vol, sobel_axis, border_type);
+            if (use_integer_path) {
+                filtered_vol = ImageFilter::to_double_volume(ImageFilter::sobel_int(
+                    ImageFilter::to_int_volume(input_vol), sobel_axis, border_type));
+            } else {
+                filtered_vol = ImageFilter::sobel(input_vol, sobel_axis, border_type);
+            }
+        } else if (use_wiener_filter) {
+            std::cout << "执行自适应Wiener滤波（窗口=" << wiener_size[0] << "×" << wiener_size[1]
+                      << "×" << wiener_size[2] << "）..." << std::endl;
+            filtered_vol = ImageFilter::wiener_filter(input_vol, wiener_size, -1.0, border_type);
+        } else if (use_bilateral_filter) {
+            std::cout << "执行双边滤波（空间sigma=" << bilateral_sigma_spatial
+                      << "，灰度sigma=" << bilateral_sigma_range << "）..." << std::endl;
+            filtered_vol = ImageFilter::bilateral_filter(input_vol, bilateral_sigma_spatial, bilateral_sigma_range);
         } else {
-            throw std::runtime_error("未选择任何滤波方式！请设置use_gaussian_filter或use_sobel_filter为true");
+            throw std::runtime_error("未选择任何滤波方式！请设置use_gaussian_filter、use_sobel_filter、use_wiener_filter或use_bilateral_filter为true");
         }
         std::cout << "滤波处理完成" << std::endl;
 
+        PoolStats pool_stats = VolumePool::instance().stats();
+        std::cout << "缓冲池：峰值 " << (pool_stats.peak_bytes >> 20) << " MB，缓存 "
+                  << (pool_stats.bytes_cached >> 20) << " MB，借出 " << pool_stats.acquires
+                  << " 次（复用 " << pool_stats.reuses << " 次）" << std::endl;
+        VolumePool::instance().trim();
+
         // 保存DCM文件（保持不变）
         std::cout << "\n===== 开始保存DCM文件 =====" << std::endl;
         save_mat3d_to_dcm(filtered_vol, output_folder, metaDictionaries, spacing);
@@ -0,0 +1,180 @@
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+// windows.h默认定义min/max宏，会破坏std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "ImageFilter.h"
+
+
+// 解析sysfs中的cpulist格式（如"0-3,8-11"）
+static std::vector<int> parse_cpulist(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        int first = std::stoi(item.substr(0, dash));
+        int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+        for (int c = first; c <= last; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+// 按NUMA节点顺序排列的CPU列表：相邻线程（相邻z切片块）落在同一节点
+static std::vector<int> node_ordered_cpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    for (int node = 0;; ++node) {
+        std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!f) break;
+        std::string text;
+        std::getline(f, text);
+        std::vector<int> node_cpus = parse_cpulist(text);
+        cpus.insert(cpus.end(), node_cpus.begin(), node_cpus.end());
+    }
+#endif
+    if (cpus.empty()) {
+        int n = std::max(1u, std::thread::hardware_concurrency());
+        for (int c = 0; c < n; ++c) cpus.push_back(c);
+    }
+    return cpus;
+}
+
+// 将当前线程绑定到指定CPU（不支持的平台上忽略）
+static void pin_current_thread(int cpu) {
+#if defined(_WIN32)
+    if (cpu < 64) SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+int ImageFilter::numa_node_count() {
+    int nodes = 0;
+#if defined(__linux__)
+    while (std::ifstream("/sys/devices/system/node/node" + std::to_string(nodes) + "/cpulist")) ++nodes;
+#endif
+    return std::max(1, nodes);
+}
+
+void ImageFilter::parallel_for_slabs(int depth, const std::function<void(int, int)>& fn,
+                                     int num_threads, bool pin) {
+    if (depth <= 0) return;
+    std::vector<int> cpus = node_ordered_cpus();
+    int threads = num_threads > 0 ? num_threads : static_cast<int>(cpus.size());
+    threads = std::min(threads, depth);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        int begin = static_cast<int>(static_cast<long long>(depth) * t / threads);
+        int end = static_cast<int>(static_cast<long long>(depth) * (t + 1) / threads);
+        // 线程在node顺序的CPU列表上均匀分布
+        int cpu = cpus[static_cast<size_t>(t) * cpus.size() / threads];
+        workers.emplace_back([&fn, begin, end, cpu, pin]() {
+            if (pin) pin_current_thread(cpu);
+            fn(begin, end);
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+Mat3D ImageFilter::first_touch_volume(int depth, int rows, int cols, int num_threads, bool pin) {
+    Mat3D volume(std::max(0, depth));
+    parallel_for_slabs(depth, [&](int z0, int z1) {
+        for (int z = z0; z < z1; ++z) {
+            volume[z] = Mat2D(rows, std::vector<double>(cols, 0.0));
+        }
+    }, num_threads, pin);
+    return volume;
+}
+
+// 计算一个切片块[z0, z1)的1D相关结果；输出切片由调用线程分配（first-touch）
+// index为该轴两端各填充k_half后的源索引表（-1表示CONSTANT填充）
+static void correlate_slab(const Mat3D& in, Mat3D& out, const std::vector<double>& weights,
+                           int axis, int z0, int z1, const std::vector<int>& index, double cval) {
+    int rows = in[0].size();
+    int cols = in[0][0].size();
+    int ksize = weights.size();
+    int k_half = ksize / 2;
+
+    std::vector<double> const_row(cols, cval);
+    std::vector<double> buf(cols + 2 * k_half);
+    for (int z = z0; z < z1; ++z) {
+        out[z] = Mat2D(rows, std::vector<double>(cols, 0.0));
+        for (int r = 0; r < rows; ++r) {
+            std::vector<double>& dst = out[z][r];
+            if (axis == 1) {  // 列方向：构造填充行
+                const std::vector<double>& row = in[z][r];
+                for (int i = 0; i < cols + 2 * k_half; ++i) {
+                    int src = index[i];
+                    buf[i] = src < 0 ? cval : row[src];
+                }
+                for (int k = 0; k < ksize; ++k) {
+                    double w = weights[k];
+                    const double* b = buf.data() + k;
+                    for (int c = 0; c < cols; ++c) dst[c] += b[c] * w;
+                }
+            } else {  // 行/深度方向：整行累加
+                int pos = axis == 0 ? r : z;
+                for (int k = 0; k < ksize; ++k) {
+                    int src = index[pos + k];
+                    const std::vector<double>& row = src < 0 ? const_row
+                                                   : (axis == 0 ? in[z][src] : in[src][r]);
+                    double w = weights[k];
+                    for (int c = 0; c < cols; ++c) dst[c] += row[c] * w;
+                }
+            }
+        }
+    }
+}
+
+Mat3D ImageFilter::gaussian_filter_numa(const Mat3D& input, double sigma, int borderType,
+                                        double cval, int num_threads, bool pin) {
+    if (input.empty()) return {};
+    int depth = input.size();
+    int rows = input[0].size();
+    int cols = input[0][0].size();
+    auto kernel = getGaussianWeights(sigma);
+    int k_half = kernel.size() / 2;
+    std::vector<int> row_index = getSourceIndexTable(rows, k_half, k_half, borderType);
+    std::vector<int> col_index = getSourceIndexTable(cols, k_half, k_half, borderType);
+    std::vector<int> depth_index = getSourceIndexTable(depth, k_half, k_half, borderType);
+
+    // 三趟使用相同的切片块划分与绑核，每个线程始终处理自己的z块
+    Mat3D a(depth), b(depth);
+    parallel_for_slabs(depth, [&](int z0, int z1) {
+        correlate_slab(input, a, kernel, 0, z0, z1, row_index, cval);
+    }, num_threads, pin);
+    parallel_for_slabs(depth, [&](int z0, int z1) {
+        correlate_slab(a, b, kernel, 1, z0, z1, col_index, cval);
+    }, num_threads, pin);
+    // 中间结果a在第三趟中被整块重新分配，沿用同一划分即可
+    parallel_for_slabs(depth, [&](int z0, int z1) {
+        correlate_slab(b, a, kernel, 2, z0, z1, depth_index, cval);
+    }, num_threads, pin);
+    return a;
+}
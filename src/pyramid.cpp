@@ -0,0 +1,154 @@
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "ImageFilter.h"
+
+
+// 融合的1D相关+降采样：只计算保留的输出点，不做整体填充
+void ImageFilter::correlate1d_decimate(const Mat3D& input, const std::vector<double>& weights,
+                                       int axis, int factor, Mat3D& output,
+                                       int borderType, double cval) {
+    if (input.empty() || weights.empty()) return;
+    if (axis < 0 || axis > 2) throw std::invalid_argument("Invalid axis (0-2)");
+    if (factor < 1) throw std::invalid_argument("Decimation factor must be >= 1");
+
+    int depth = input.size();
+    int rows = input[0].size();
+    int cols = input[0][0].size();
+    int ksize = weights.size();
+
+    int sizes[3] = {rows, cols, depth};
+    int n = sizes[axis];
+    int out_n = (n + factor - 1) / factor;
+    // 输出点j的第k个核元素对应源索引index[j * factor + k]（-1表示CONSTANT填充）
+    int k_half = ksize / 2;
+    std::vector<int> index = getSourceIndexTable(n, k_half, ksize - 1 - k_half, borderType);
+
+    // CONSTANT边界的贡献与位置无关，预先累加
+    std::vector<double> const_part(out_n, 0.0);
+    for (int j = 0; j < out_n; ++j) {
+        for (int k = 0; k < ksize; ++k) {
+            if (index[static_cast<size_t>(j) * factor + k] < 0) const_part[j] += weights[k] * cval;
+        }
+    }
+
+    if (axis == 0) {  // 行方向：按整行累加，内层沿列连续访问
+        output = Mat3D(depth, Mat2D(out_n, std::vector<double>(cols, 0.0)));
+        for (int z = 0; z < depth; ++z) {
+            for (int j = 0; j < out_n; ++j) {
+                std::vector<double>& dst = output[z][j];
+                std::fill(dst.begin(), dst.end(), const_part[j]);
+                for (int k = 0; k < ksize; ++k) {
+                    int src = index[static_cast<size_t>(j) * factor + k];
+                    if (src < 0) continue;
+                    const std::vector<double>& row = input[z][src];
+                    double w = weights[k];
+                    for (int c = 0; c < cols; ++c) dst[c] += row[c] * w;
+                }
+            }
+        }
+    } else if (axis == 1) {  // 列方向
+        output = Mat3D(depth, Mat2D(rows, std::vector<double>(out_n, 0.0)));
+        for (int z = 0; z < depth; ++z) {
+            for (int r = 0; r < rows; ++r) {
+                const std::vector<double>& row = input[z][r];
+                std::vector<double>& dst = output[z][r];
+                for (int j = 0; j < out_n; ++j) {
+                    const int* t = &index[static_cast<size_t>(j) * factor];
+                    double sum = const_part[j];
+                    for (int k = 0; k < ksize; ++k) {
+                        if (t[k] >= 0) sum += row[t[k]] * weights[k];
+                    }
+                    dst[j] = sum;
+                }
+            }
+        }
+    } else {  // 深度方向：按整个切片累加
+        output = Mat3D(out_n, Mat2D(rows, std::vector<double>(cols, 0.0)));
+        for (int j = 0; j < out_n; ++j) {
+            for (int r = 0; r < rows; ++r) {
+                std::fill(output[j][r].begin(), output[j][r].end(), const_part[j]);
+            }
+            for (int k = 0; k < ksize; ++k) {
+                int src = index[static_cast<size_t>(j) * factor + k];
+                if (src < 0) continue;
+                double w = weights[k];
+                for (int r = 0; r < rows; ++r) {
+                    const std::vector<double>& row = input[src][r];
+                    std::vector<double>& dst = output[j][r];
+                    for (int c = 0; c < cols; ++c) dst[c] += row[c] * w;
+                }
+            }
+        }
+    }
+}
+
+// 高斯平滑并降采样（只在需要降采样的轴上平滑）
+Mat3D ImageFilter::gaussian_downsample(const Mat3D& input, double sigma,
+                                       const std::vector<int>& factors,
+                                       int borderType, double cval) {
+    if (input.empty()) return {};
+    if (factors.size() < 3) throw std::invalid_argument("Factors must have 3 elements");
+    for (int f : factors) {
+        if (f < 1) throw std::invalid_argument("Decimation factor must be >= 1");
+    }
+
+    auto kernel = getGaussianWeights(sigma);
+
+    // 先处理深度轴，使后续行/列两趟的切片数量尽早减少
+    const int order[3] = {2, 0, 1};
+    Mat3D result = input;
+    for (int axis : order) {
+        if (factors[axis] == 1) continue;
+        Mat3D temp;
+        correlate1d_decimate(result, kernel, axis, factors[axis], temp, borderType, cval);
+        result = std::move(temp);
+    }
+    return result;
+}
+
+// 多分辨率高斯金字塔
+std::vector<PyramidLevel> ImageFilter::gaussian_pyramid(const Mat3D& input,
+                                                        const std::vector<double>& spacing,
+                                                        int levels, double sigma,
+                                                        int borderType, double cval) {
+    if (spacing.size() < 3) throw std::invalid_argument("Spacing must have 3 elements");
+    if (levels < 1) throw std::invalid_argument("Pyramid levels must be >= 1");
+
+    std::vector<PyramidLevel> pyramid;
+    if (input.empty()) return pyramid;
+    pyramid.push_back({input, {spacing[0], spacing[1], spacing[2]}, {1, 1, 1}});
+
+    // 轴索引与spacing索引的对应：行->y, 列->x, 深度->z
+    const int spacing_idx[3] = {1, 0, 2};
+
+    for (int level = 1; level < levels; ++level) {
+        const PyramidLevel& prev = pyramid.back();
+        int sizes[3] = {static_cast<int>(prev.data[0].size()),
+                        static_cast<int>(prev.data[0][0].size()),
+                        static_cast<int>(prev.data.size())};
+        double min_spacing = std::min({prev.spacing[0], prev.spacing[1], prev.spacing[2]});
+
+        PyramidLevel next;
+        next.spacing = prev.spacing;
+        next.factors = {1, 1, 1};
+        bool shrink = false;
+        for (int axis = 0; axis < 3; ++axis) {
+            double s = prev.spacing[spacing_idx[axis]];
+            // 已明显粗于其他轴的方向暂不降采样；只剩1个体素的轴也不再降采样
+            if (s < 2.0 * min_spacing && sizes[axis] > 1) {
+                next.factors[axis] = 2;
+                next.spacing[spacing_idx[axis]] = s * 2.0;
+                shrink = true;
+            }
+        }
+        if (!shrink) break;
+
+        next.data = gaussian_downsample(prev.data, sigma, next.factors, borderType, cval);
+        pyramid.push_back(std::move(next));
+    }
+
+    return pyramid;
+}
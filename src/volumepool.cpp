@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "VolumePool.h"
+
+
+static const size_t kCacheLine = 64;
+static const size_t kHugePage = size_t(2) << 20;
+
+// 按容量决定对齐方式：>=2MB的缓冲区按大页对齐
+static size_t buffer_alignment(size_t bytes) {
+    return bytes >= kHugePage ? kHugePage : kCacheLine;
+}
+
+static size_t volume_bytes(int depth, int rows, int cols) {
+    return static_cast<size_t>(depth) * rows * cols * sizeof(double);
+}
+
+// 体数据的标识：首行的数据地址，在Mat3D移动或swap后保持不变
+static const double* volume_key(const Mat3D& volume) {
+    return volume.empty() || volume[0].empty() ? nullptr : volume[0][0].data();
+}
+
+VolumePool& VolumePool::instance() {
+    static VolumePool pool;
+    return pool;
+}
+
+VolumePool::~VolumePool() {
+    for (const auto& entry : free_buffers_) {
+        ::operator delete(entry.second, std::align_val_t(buffer_sizes_.at(entry.second).alignment));
+    }
+}
+
+void VolumePool::set_limit(size_t bytes, bool block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.limit_bytes = bytes;
+    block_ = block;
+    // 不设上限时不缓存，已有缓存全部释放
+    while ((bytes == 0 || stats_.bytes_in_use + stats_.bytes_cached > bytes) && evict_one_locked()) {
+    }
+    released_.notify_all();
+}
+
+void VolumePool::borrow_locked(std::thread::id owner, size_t size) {
+    stats_.bytes_in_use += size;
+    in_use_by_thread_[owner] += size;
+}
+
+void VolumePool::give_back_locked(std::thread::id owner, size_t size) {
+    stats_.bytes_in_use -= size;
+    auto it = in_use_by_thread_.find(owner);
+    if (it != in_use_by_thread_.end() && (it->second -= size) == 0) in_use_by_thread_.erase(it);
+}
+
+size_t VolumePool::releasable_by_others_locked(std::thread::id self) const {
+    size_t bytes = 0;
+    for (const auto& entry : in_use_by_thread_) {
+        if (entry.first != self && waiting_.count(entry.first) == 0) bytes += entry.second;
+    }
+    return bytes;
+}
+
+void VolumePool::update_peak_locked() {
+    stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.bytes_in_use + stats_.bytes_cached);
+}
+
+bool VolumePool::evict_one_locked() {
+    for (auto it = free_volumes_.begin(); it != free_volumes_.end(); ++it) {
+        if (it->second.empty()) continue;
+        const Shape& shape = it->first;
+        stats_.bytes_cached -= volume_bytes(std::get<0>(shape), std::get<1>(shape), std::get<2>(shape));
+        it->second.pop_back();
+        if (it->second.empty()) free_volumes_.erase(it);
+        return true;
+    }
+    if (!free_buffers_.empty()) {
+        auto it = std::prev(free_buffers_.end());  // 优先释放最大的缓冲区
+        size_t bytes = it->first * sizeof(double);
+        stats_.bytes_cached -= bytes;
+        auto info = buffer_sizes_.find(it->second);
+        ::operator delete(it->second, std::align_val_t(info->second.alignment));
+        buffer_sizes_.erase(info);
+        free_buffers_.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void VolumePool::reserve_locked(std::unique_lock<std::mutex>& lock, size_t size) {
+    size_t limit = stats_.limit_bytes;
+    if (limit == 0) return;
+    if (size > limit) throw std::runtime_error("Volume pool request exceeds the memory limit");
+
+    while (stats_.bytes_in_use + stats_.bytes_cached + size > limit) {
+        if (evict_one_locked()) continue;
+        if (!block_) throw std::runtime_error("Volume pool memory limit exceeded");
+        // 只有其他未在等待的线程归还内存才可能满足请求，不足时等待永远不会结束
+        std::thread::id self = std::this_thread::get_id();
+        size_t shortfall = stats_.bytes_in_use + size - limit;
+        if (releasable_by_others_locked(self) < shortfall) {
+            throw std::runtime_error("Volume pool memory limit exceeded and no other thread can release enough memory");
+        }
+        ++stats_.waits;
+        waiting_.insert(self);
+        released_.wait(lock);
+        waiting_.erase(self);
+        limit = stats_.limit_bytes;
+        if (limit == 0) return;
+    }
+}
+
+Mat3D VolumePool::acquire(int depth, int rows, int cols) {
+    size_t size = volume_bytes(depth, rows, cols);
+    std::thread::id self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++stats_.acquires;
+
+    auto it = free_volumes_.find(Shape(depth, rows, cols));
+    if (it != free_volumes_.end() && !it->second.empty()) {
+        Mat3D volume = std::move(it->second.back());
+        it->second.pop_back();
+        if (it->second.empty()) free_volumes_.erase(it);
+        stats_.bytes_cached -= size;
+        borrow_locked(self, size);
+        ++stats_.reuses;
+        outstanding_[volume_key(volume)] = self;
+        return volume;
+    }
+
+    reserve_locked(lock, size);
+    borrow_locked(self, size);
+    ++stats_.allocations;
+    update_peak_locked();
+    lock.unlock();
+
+    try {
+        Mat3D volume(depth, Mat2D(rows, std::vector<double>(cols, 0.0)));
+        std::lock_guard<std::mutex> relock(mutex_);
+        outstanding_[volume_key(volume)] = self;
+        return volume;
+    } catch (...) {
+        std::lock_guard<std::mutex> relock(mutex_);
+        give_back_locked(self, size);
+        released_.notify_all();
+        throw;
+    }
+}
+
+void VolumePool::release(Mat3D&& volume) {
+    if (volume.empty() || volume[0].empty()) {
+        volume.clear();
+        return;
+    }
+    Shape shape(static_cast<int>(volume.size()), static_cast<int>(volume[0].size()),
+                static_cast<int>(volume[0][0].size()));
+    size_t size = volume_bytes(std::get<0>(shape), std::get<1>(shape), std::get<2>(shape));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = outstanding_.find(volume_key(volume));
+    if (it != outstanding_.end()) {
+        give_back_locked(it->second, size);
+        outstanding_.erase(it);
+    }
+    if (stats_.limit_bytes == 0) {
+        // 不设上限时不缓存：先释放内存再唤醒等待者
+        lock.unlock();
+        Mat3D dropped = std::move(volume);
+        volume.clear();
+        dropped = Mat3D();
+        released_.notify_all();
+        return;
+    }
+    // 不是由池借出的体数据（或已移交给调用者的结果）直接纳入缓存
+    stats_.bytes_cached += size;
+    free_volumes_[shape].push_back(std::move(volume));
+    volume.clear();
+    update_peak_locked();
+
+    size_t limit = stats_.limit_bytes;
+    while (limit > 0 && stats_.bytes_in_use + stats_.bytes_cached > limit && evict_one_locked()) {
+    }
+    released_.notify_all();
+}
+
+void VolumePool::discard(Mat3D&& volume) {
+    Mat3D dropped = std::move(volume);
+    volume.clear();
+    if (dropped.empty() || dropped[0].empty()) return;
+    size_t size = volume_bytes(static_cast<int>(dropped.size()), static_cast<int>(dropped[0].size()),
+                               static_cast<int>(dropped[0][0].size()));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = outstanding_.find(volume_key(dropped));
+        if (it == outstanding_.end()) return;
+        give_back_locked(it->second, size);
+        outstanding_.erase(it);
+    }
+    // 先释放内存再唤醒等待者
+    dropped = Mat3D();
+    released_.notify_all();
+}
+
+void VolumePool::detach(const Mat3D& volume) {
+    if (volume.empty() || volume[0].empty()) return;
+    size_t size = volume_bytes(static_cast<int>(volume.size()), static_cast<int>(volume[0].size()),
+                               static_cast<int>(volume[0][0].size()));
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = outstanding_.find(volume_key(volume));
+    if (it != outstanding_.end()) {
+        give_back_locked(it->second, size);
+        outstanding_.erase(it);
+        released_.notify_all();
+    }
+}
+
+double* VolumePool::acquire_buffer(size_t count) {
+    std::thread::id self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++stats_.acquires;
+
+    // 复用容量在[count, 2*count]之间的缓存，避免大缓冲区被小请求长期占用
+    auto it = free_buffers_.lower_bound(count);
+    if (it != free_buffers_.end() && it->first <= 2 * count) {
+        double* buffer = it->second;
+        size_t bytes = it->first * sizeof(double);
+        free_buffers_.erase(it);
+        stats_.bytes_cached -= bytes;
+        borrow_locked(self, bytes);
+        buffer_sizes_.at(buffer).owner = self;
+        ++stats_.reuses;
+        return buffer;
+    }
+
+    size_t bytes = std::max<size_t>(count, 1) * sizeof(double);
+    size_t align = buffer_alignment(bytes);
+    bytes = (bytes + align - 1) / align * align;
+    reserve_locked(lock, bytes);
+
+    double* buffer = static_cast<double*>(::operator new(bytes, std::align_val_t(align)));
+#if defined(__linux__)
+    if (align == kHugePage) madvise(buffer, bytes, MADV_HUGEPAGE);
+#endif
+    buffer_sizes_[buffer] = BufferInfo{bytes / sizeof(double), align, self};
+    borrow_locked(self, bytes);
+    ++stats_.allocations;
+    update_peak_locked();
+    return buffer;
+}
+
+void VolumePool::release_buffer(double* buffer) {
+    if (!buffer) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buffer_sizes_.find(buffer);
+    if (it == buffer_sizes_.end()) throw std::invalid_argument("Buffer was not acquired from this pool");
+
+    size_t bytes = it->second.count * sizeof(double);
+    give_back_locked(it->second.owner, bytes);
+    if (stats_.limit_bytes == 0) {  // 不设上限时不缓存
+        ::operator delete(buffer, std::align_val_t(it->second.alignment));
+        buffer_sizes_.erase(it);
+        released_.notify_all();
+        return;
+    }
+    stats_.bytes_cached += bytes;
+    free_buffers_.insert({it->second.count, buffer});
+
+    size_t limit = stats_.limit_bytes;
+    while (limit > 0 && stats_.bytes_in_use + stats_.bytes_cached > limit && evict_one_locked()) {
+    }
+    released_.notify_all();
+}
+
+void VolumePool::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (evict_one_locked()) {
+    }
+    released_.notify_all();
+}
+
+PoolStats VolumePool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
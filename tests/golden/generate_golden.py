@@ -0,0 +1,71 @@
+"""生成ImageFilter回归测试的scipy.ndimage参考结果（.npy，float64）
+
+用法：python tests/golden/generate_golden.py   （需要numpy、scipy）
+输出写入本脚本所在目录，重新生成后需提交更新的.npy文件。
+
+坐标约定：numpy数组形状为(z, 行, 列)，与Mat3D[z][r][c]一致；
+ImageFilter的轴0/1/2（行/列/深度）分别对应numpy轴1/2/0。
+"""
+import os
+
+import numpy as np
+from scipy import ndimage
+
+OUT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+# borderType 0..3 对应的scipy模式
+MODES = ["constant", "nearest", "reflect", "mirror"]
+CVAL = 100.0
+# ImageFilter轴 -> numpy轴
+NP_AXIS = [1, 2, 0]
+
+GAUSS_SIGMA = 1.0
+GAUSS1D_SIGMA = 1.5
+THIN_SIGMA = 4.0          # 半径16，大于thin体数据的所有维度
+ODD_KERNEL = [0.5, -1.0, 2.0, 0.25, 1.0]
+EVEN_KERNEL = [0.25, -1.0, 2.0, 0.5]
+EDIT_SLICES = (2, 4)      # vol_edit相对vol被修改的切片[begin, end)
+STATS_SIZE = (3, 4, 5)    # 局部统计窗口（numpy轴顺序z、行、列），含偶数尺寸
+
+
+def save(name, array):
+    np.save(os.path.join(OUT_DIR, name + ".npy"), np.ascontiguousarray(array, dtype=np.float64))
+
+
+def per_axis(fn):
+    return np.stack([fn(NP_AXIS[axis]) for axis in range(3)])
+
+
+def main():
+    rng = np.random.default_rng(20240601)
+    # 奇数尺寸；12位整数灰度，便于同时检验整数/定点路径
+    vol = rng.integers(0, 4096, size=(7, 9, 11)).astype(np.float64)
+    vol_edit = vol.copy()
+    vol_edit[EDIT_SLICES[0]:EDIT_SLICES[1]] = rng.integers(0, 4096, size=(EDIT_SLICES[1] - EDIT_SLICES[0], 9, 11))
+    thin = rng.integers(0, 4096, size=(1, 5, 3)).astype(np.float64)
+
+    save("vol", vol)
+    save("vol_edit", vol_edit)
+    save("thin", thin)
+
+    for mode in MODES:
+        kw = dict(mode=mode, cval=CVAL)
+        save("gaussian_" + mode, ndimage.gaussian_filter(vol, GAUSS_SIGMA, truncate=4.0, **kw))
+        save("gaussian_edit_" + mode, ndimage.gaussian_filter(vol_edit, GAUSS_SIGMA, truncate=4.0, **kw))
+        save("thin_gaussian_" + mode, ndimage.gaussian_filter(thin, THIN_SIGMA, truncate=4.0, **kw))
+        save("gaussian1d_" + mode,
+             per_axis(lambda ax: ndimage.gaussian_filter1d(vol, GAUSS1D_SIGMA, axis=ax, truncate=4.0, **kw)))
+        save("correlate_" + mode,
+             per_axis(lambda ax: ndimage.correlate1d(vol, ODD_KERNEL, axis=ax, **kw)))
+        save("correlate_even_" + mode,
+             per_axis(lambda ax: ndimage.correlate1d(vol, EVEN_KERNEL, axis=ax, **kw)))
+        save("sobel_" + mode, per_axis(lambda ax: ndimage.sobel(vol, axis=ax, **kw)))
+        save("uniform_" + mode, ndimage.uniform_filter(vol, STATS_SIZE, **kw))
+        save("minimum_" + mode, ndimage.minimum_filter(vol, STATS_SIZE, **kw))
+        save("maximum_" + mode, ndimage.maximum_filter(vol, STATS_SIZE, **kw))
+        # 局部总体方差按窗口逐点直接计算，不经过E[x²]-E[x]²
+        save("variance_" + mode, ndimage.generic_filter(vol, np.var, STATS_SIZE, **kw))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,465 @@
+// ImageFilter回归测试：与scipy.ndimage生成的参考结果（tests/golden/*.npy）逐点比较，
+// 并检查各执行路径的吞吐量。误差阈值与吞吐量基线记录在tests/golden/thresholds.txt。
+// 覆盖的数值路径为double（Mat3D）与整数/定点（Mat3DI）；ImageFilter没有float32路径，因此不做float32检查。
+//
+// 用法：filterTests golden <golden目录>
+//       filterTests throughput <golden目录>   吞吐量低于基线的kThroughputFraction倍时失败
+//       filterTests record <golden目录>       输出本机实测值，格式同阈值文件，可作为本机基线文件
+// 环境变量FILTER_THROUGHPUT_BASELINE指向本机基线文件时，其中的throughput行覆盖thresholds.txt中的基线
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+#include "ImageFilter.h"
+
+
+// 与generate_golden.py保持一致
+static const char* kModes[4] = {"constant", "nearest", "reflect", "mirror"};
+static const double kCval = 100.0;
+static const double kGaussSigma = 1.0;
+static const double kGauss1dSigma = 1.5;
+static const double kThinSigma = 4.0;
+static const std::vector<double> kOddKernel = {0.5, -1.0, 2.0, 0.25, 1.0};
+static const std::vector<double> kEvenKernel = {0.25, -1.0, 2.0, 0.5};
+static const int kEditBegin = 2, kEditEnd = 4;
+static const std::vector<int> kStatsSize = {4, 5, 3};  // [行, 列, 深度]，即numpy的(3, 4, 5)
+static const double kStatsOffset = 1e9;                // 稳定模式检查时叠加的直流分量
+static const double kBilateralRange = 10.0;            // 双边滤波灰度sigma（HU）
+static const int kThreads = 3;
+static const double kThroughputFraction = 0.7;  // 吞吐量下限 = 基线 × 该比例
+
+// .npy文件（仅支持C顺序的little-endian float64）
+struct NpyArray {
+    std::vector<size_t> shape;
+    std::vector<double> data;
+};
+
+static NpyArray load_npy(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("Cannot open " + path);
+    char magic[8];
+    f.read(magic, 8);
+    if (!f || std::string(magic + 1, 5) != "NUMPY") throw std::runtime_error("Not a .npy file: " + path);
+
+    uint32_t header_len = 0;
+    if (magic[6] == 1) {
+        unsigned char len[2];
+        f.read(reinterpret_cast<char*>(len), 2);
+        header_len = len[0] | (len[1] << 8);
+    } else {
+        unsigned char len[4];
+        f.read(reinterpret_cast<char*>(len), 4);
+        header_len = len[0] | (len[1] << 8) | (len[2] << 16) | (static_cast<uint32_t>(len[3]) << 24);
+    }
+    std::string header(header_len, '\0');
+    f.read(&header[0], header_len);
+    if (header.find("'<f8'") == std::string::npos || header.find("'fortran_order': False") == std::string::npos) {
+        throw std::runtime_error("Unsupported .npy dtype/order: " + path);
+    }
+
+    NpyArray array;
+    size_t open = header.find('(', header.find("'shape'"));
+    size_t close = header.find(')', open);
+    std::stringstream ss(header.substr(open + 1, close - open - 1));
+    std::string item;
+    size_t count = 1;
+    while (std::getline(ss, item, ',')) {
+        if (item.find_first_not_of(' ') == std::string::npos) continue;
+        array.shape.push_back(std::stoul(item));
+        count *= array.shape.back();
+    }
+    array.data.resize(count);
+    f.read(reinterpret_cast<char*>(array.data.data()), count * sizeof(double));
+    if (!f) throw std::runtime_error("Truncated .npy file: " + path);
+    return array;
+}
+
+// 取出数组中第index个(z, 行, 列)体数据（数组为3维时index须为0）
+static Mat3D to_mat3d(const NpyArray& array, size_t index = 0) {
+    size_t n = array.shape.size();
+    int depth = array.shape[n - 3], rows = array.shape[n - 2], cols = array.shape[n - 1];
+    const double* p = array.data.data() + index * depth * rows * cols;
+    Mat3D m(depth, Mat2D(rows, std::vector<double>(cols)));
+    for (auto& slice : m)
+        for (auto& row : slice) {
+            std::copy(p, p + cols, row.begin());
+            p += cols;
+        }
+    return m;
+}
+
+// 沿ImageFilter轴axis每隔factor取一个点（即numpy的[::factor]切片）
+static Mat3D decimate(const Mat3D& m, int axis, int factor) {
+    int dims[3] = {static_cast<int>(m[0].size()), static_cast<int>(m[0][0].size()), static_cast<int>(m.size())};
+    int f[3] = {1, 1, 1};
+    f[axis] = factor;
+    Mat3D out((dims[2] + f[2] - 1) / f[2],
+              Mat2D((dims[0] + f[0] - 1) / f[0], std::vector<double>((dims[1] + f[1] - 1) / f[1])));
+    for (size_t z = 0; z < out.size(); ++z)
+        for (size_t r = 0; r < out[z].size(); ++r)
+            for (size_t c = 0; c < out[z][r].size(); ++c)
+                out[z][r][c] = m[z * f[2]][r * f[0]][c * f[1]];
+    return out;
+}
+
+static Mat3D decimate_all(const Mat3D& m, int factor) {
+    return decimate(decimate(decimate(m, 0, factor), 1, factor), 2, factor);
+}
+
+static Mat3D add_offset(Mat3D m, double offset) {
+    for (auto& slice : m)
+        for (auto& row : slice)
+            for (double& v : row) v += offset;
+    return m;
+}
+
+static double max_abs_diff(const Mat3D& a, const Mat3D& b) {
+    if (a.size() != b.size() || a[0].size() != b[0].size() || a[0][0].size() != b[0][0].size()) {
+        return INFINITY;
+    }
+    double err = 0.0;
+    for (size_t z = 0; z < a.size(); ++z)
+        for (size_t r = 0; r < a[z].size(); ++r)
+            for (size_t c = 0; c < a[z][r].size(); ++c) {
+                double d = std::fabs(a[z][r][c] - b[z][r][c]);
+                if (!(d <= err)) err = d;  // NaN也视为最大误差
+            }
+    return err;
+}
+
+// 双边滤波的逐点直接计算参考：空间核截断于2*sigma_spatial，窗口只取体数据内的体素
+static Mat3D brute_force_bilateral(const Mat3D& in, double sigma_spatial, double sigma_range) {
+    int depth = in.size(), rows = in[0].size(), cols = in[0][0].size();
+    int radius = static_cast<int>(std::ceil(2 * sigma_spatial));
+    Mat3D out = in;
+    for (int z = 0; z < depth; ++z)
+        for (int r = 0; r < rows; ++r)
+            for (int c = 0; c < cols; ++c) {
+                double v = in[z][r][c], num = 0.0, den = 0.0;
+                for (int dz = std::max(-radius, -z); dz <= std::min(radius, depth - 1 - z); ++dz)
+                    for (int dr = std::max(-radius, -r); dr <= std::min(radius, rows - 1 - r); ++dr)
+                        for (int dc = std::max(-radius, -c); dc <= std::min(radius, cols - 1 - c); ++dc) {
+                            double u = in[z + dz][r + dr][c + dc];
+                            double w = std::exp(-(dz * dz + dr * dr + dc * dc) / (2 * sigma_spatial * sigma_spatial)
+                                                - (u - v) * (u - v) / (2 * sigma_range * sigma_range));
+                            num += w * u;
+                            den += w;
+                        }
+                out[z][r][c] = num / den;
+            }
+    return out;
+}
+
+// 阈值文件：每行"tolerance <路径> <最大绝对误差>"或"throughput <路径> <基线Mvox/s>"
+struct Thresholds {
+    std::map<std::string, double> tolerance;
+    std::map<std::string, double> throughput;
+};
+
+static Thresholds load_thresholds(const std::string& path) {
+    std::ifstream f(path);
+    if (!f) throw std::runtime_error("Cannot open " + path);
+    Thresholds t;
+    std::string line;
+    while (std::getline(f, line)) {
+        std::stringstream ss(line);
+        std::string kind, name;
+        double value;
+        if (!(ss >> kind) || kind[0] == '#') continue;
+        if (!(ss >> name >> value)) throw std::runtime_error("Malformed threshold line: " + line);
+        if (kind == "tolerance") t.tolerance[name] = value;
+        else if (kind == "throughput") t.throughput[name] = value;
+        else throw std::runtime_error("Unknown threshold kind: " + kind);
+    }
+    return t;
+}
+
+struct Checker {
+    const Thresholds& thresholds;
+    int checks = 0;
+    int failures = 0;
+    std::map<std::string, double> worst = {};  // 各路径的最大误差，便于重新记录阈值
+
+    void expect(const std::string& path, const std::string& what, const Mat3D& got, const Mat3D& want) {
+        auto it = thresholds.tolerance.find(path);
+        if (it == thresholds.tolerance.end()) throw std::runtime_error("No tolerance recorded for " + path);
+        double err = max_abs_diff(got, want);
+        worst[path] = std::max(worst[path], err);
+        ++checks;
+        if (!(err <= it->second)) {
+            ++failures;
+            std::cerr << "FAIL [" << path << "] " << what << ": max abs error " << err
+                      << " > " << it->second << std::endl;
+        }
+    }
+
+    void require(const std::string& what, bool ok) {
+        ++checks;
+        if (!ok) {
+            ++failures;
+            std::cerr << "FAIL " << what << std::endl;
+        }
+    }
+};
+
+static int run_golden(const std::string& dir) {
+    Thresholds thresholds = load_thresholds(dir + "/thresholds.txt");
+    Checker check{thresholds};
+    auto load = [&](const std::string& name) { return load_npy(dir + "/" + name + ".npy"); };
+
+    Mat3D vol = to_mat3d(load("vol"));
+    Mat3D vol_edit = to_mat3d(load("vol_edit"));
+    Mat3D thin = to_mat3d(load("thin"));
+    Mat3DI vol_int = ImageFilter::to_int_volume(vol);
+    const int icval = static_cast<int>(kCval);
+
+    for (int bt = 0; bt < 4; ++bt) {
+        const std::string mode = kModes[bt];
+        Mat3D gauss = to_mat3d(load("gaussian_" + mode));
+        Mat3D gauss_edit = to_mat3d(load("gaussian_edit_" + mode));
+        Mat3D thin_gauss = to_mat3d(load("thin_gaussian_" + mode));
+        NpyArray gauss1d = load("gaussian1d_" + mode);
+        NpyArray corr = load("correlate_" + mode);
+        NpyArray corr_even = load("correlate_even_" + mode);
+        NpyArray sob = load("sobel_" + mode);
+
+        // 串行路径
+        check.expect("serial", "gaussian_filter " + mode,
+                     ImageFilter::gaussian_filter(vol, kGaussSigma, bt, kCval), gauss);
+        check.expect("serial", "gaussian_filter radius>dims " + mode,
+                     ImageFilter::gaussian_filter(thin, kThinSigma, bt, kCval), thin_gauss);
+        for (int axis = 0; axis < 3; ++axis) {
+            std::string ax = " axis" + std::to_string(axis) + " " + mode;
+            Mat3D out;
+            ImageFilter::gaussian_filter1d(vol, kGauss1dSigma, axis, out, bt, kCval);
+            check.expect("serial", "gaussian_filter1d" + ax, out, to_mat3d(gauss1d, axis));
+            ImageFilter::correlate1d(vol, kOddKernel, axis, out, bt, kCval);
+            check.expect("serial", "correlate1d" + ax, out, to_mat3d(corr, axis));
+            ImageFilter::correlate1d(vol, kEvenKernel, axis, out, bt, kCval);
+            check.expect("serial", "correlate1d even kernel" + ax, out, to_mat3d(corr_even, axis));
+            check.expect("serial", "sobel" + ax, ImageFilter::sobel(vol, axis, bt, kCval), to_mat3d(sob, axis));
+        }
+
+        // 多线程路径：NUMA切片块划分、批处理（count=1为连续布局，count=2且列数<16为交错布局）
+        check.expect("threaded", "gaussian_filter_numa " + mode,
+                     ImageFilter::gaussian_filter_numa(vol, kGaussSigma, bt, kCval, kThreads), gauss);
+        check.expect("threaded", "gaussian_filter_numa radius>dims " + mode,
+                     ImageFilter::gaussian_filter_numa(thin, kThinSigma, bt, kCval, kThreads), thin_gauss);
+        VolumeBatch single = ImageFilter::make_batch({vol});
+        VolumeBatch pair = ImageFilter::make_batch({vol, vol_edit});
+        check.expect("threaded", "gaussian_filter_batch count=1 " + mode,
+                     ImageFilter::unpack_batch(ImageFilter::gaussian_filter_batch(single, kGaussSigma, bt, kCval,
+                                                                                  kThreads))[0], gauss);
+        std::vector<Mat3D> gp = ImageFilter::unpack_batch(
+            ImageFilter::gaussian_filter_batch(pair, kGaussSigma, bt, kCval, kThreads));
+        check.expect("threaded", "gaussian_filter_batch interleaved[0] " + mode, gp[0], gauss);
+        check.expect("threaded", "gaussian_filter_batch interleaved[1] " + mode, gp[1], gauss_edit);
+        for (int axis = 0; axis < 3; ++axis) {
+            std::string ax = " axis" + std::to_string(axis) + " " + mode;
+            for (const VolumeBatch* b : {&single, &pair}) {
+                std::string layout = b->count == 1 ? " count=1" : " interleaved";
+                VolumeBatch out;
+                ImageFilter::correlate1d_batch(*b, kOddKernel, axis, out, bt, kCval, kThreads);
+                check.expect("threaded", "correlate1d_batch" + layout + ax,
+                             ImageFilter::unpack_batch(out)[0], to_mat3d(corr, axis));
+                ImageFilter::correlate1d_batch(*b, kEvenKernel, axis, out, bt, kCval, kThreads);
+                check.expect("threaded", "correlate1d_batch even kernel" + layout + ax,
+                             ImageFilter::unpack_batch(out)[0], to_mat3d(corr_even, axis));
+                check.expect("threaded", "sobel_batch" + layout + ax,
+                             ImageFilter::unpack_batch(ImageFilter::sobel_batch(*b, axis, bt, kCval, kThreads))[0],
+                             to_mat3d(sob, axis));
+            }
+        }
+
+        // 局部统计：均值/最小/最大值与uniform/minimum/maximum_filter比较，方差与逐窗口np.var比较
+        Mat3D variance = to_mat3d(load("variance_" + mode));
+        LocalStats stats = ImageFilter::local_statistics(vol, kStatsSize, true, false, bt, kCval);
+        check.expect("local_stats", "local_statistics mean " + mode, stats.mean, to_mat3d(load("uniform_" + mode)));
+        check.expect("local_stats", "local_statistics min " + mode, stats.min, to_mat3d(load("minimum_" + mode)));
+        check.expect("local_stats", "local_statistics max " + mode, stats.max, to_mat3d(load("maximum_" + mode)));
+        check.expect("local_stats", "local_statistics variance " + mode, stats.variance, variance);
+        // 稳定模式：叠加大直流分量后方差不变，非稳定的E[x²]-E[x]²在此实测相消误差约9e2
+        check.expect("local_stats_stable", "local_statistics stable variance +offset " + mode,
+                     ImageFilter::local_statistics(add_offset(vol, kStatsOffset), kStatsSize, false, true,
+                                                   bt, kCval + kStatsOffset).variance, variance);
+
+        // 整数/定点路径：Sobel精确，高斯受定点核量化误差约束
+        check.expect("integer_gaussian", "gaussian_filter_int " + mode,
+                     ImageFilter::to_double_volume(ImageFilter::gaussian_filter_int(vol_int, kGaussSigma, 14,
+                                                                                    bt, icval)), gauss);
+        for (int axis = 0; axis < 3; ++axis) {
+            check.expect("integer_sobel", "sobel_int axis" + std::to_string(axis) + " " + mode,
+                         ImageFilter::to_double_volume(ImageFilter::sobel_int(vol_int, axis, bt, icval)),
+                         to_mat3d(sob, axis));
+        }
+
+        // 增量路径：缓存后修改切片[kEditBegin, kEditEnd)再增量更新
+        GaussianCache cache;
+        Mat3D inc = ImageFilter::gaussian_filter_cached(vol, kGaussSigma, cache, bt, kCval);
+        check.expect("incremental", "gaussian_filter_cached " + mode, inc, gauss);
+        ImageFilter::gaussian_filter_update(vol_edit, {{kEditBegin, kEditEnd}}, cache, inc);
+        check.expect("incremental", "gaussian_filter_update " + mode, inc, gauss_edit);
+
+        // 降采样路径：与参考结果的[::factor]切片比较
+        check.expect("decimated", "gaussian_downsample x2 " + mode,
+                     ImageFilter::gaussian_downsample(vol, kGaussSigma, {2, 2, 2}, bt, kCval),
+                     decimate_all(gauss, 2));
+        check.expect("decimated", "gaussian_pyramid level1 " + mode,
+                     ImageFilter::gaussian_pyramid(vol, {1.0, 1.0, 1.0}, 2, kGaussSigma, bt, kCval)[1].data,
+                     decimate_all(gauss, 2));
+        for (int axis = 0; axis < 3; ++axis) {
+            Mat3D out;
+            ImageFilter::correlate1d_decimate(vol, kOddKernel, axis, 3, out, bt, kCval);
+            check.expect("decimated", "correlate1d_decimate x3 axis" + std::to_string(axis) + " " + mode,
+                         out, decimate(to_mat3d(corr, axis), axis, 3));
+        }
+    }
+
+    // 双边滤波：与直接计算比较，覆盖空间网格粗于体素(sigma_spatial=2)、等于体素(0.5)，
+    // 以及灰度跨度4096、sigma_range=10时的约410个灰度层
+    {
+        const int depth = 12, rows = 20, cols = 20;
+        Mat3D step(depth, Mat2D(rows, std::vector<double>(cols)));
+        Mat3D wide = step;
+        for (int z = 0; z < depth; ++z)
+            for (int r = 0; r < rows; ++r)
+                for (int c = 0; c < cols; ++c) {
+                    // 40→100 HU阶跃边缘叠加±5 HU的确定性纹理
+                    step[z][r][c] = (c < cols / 2 ? 40 : 100) + (z * 31 + r * 17 + c * 7) % 11 - 5;
+                    wide[z][r][c] = (z * 977 + r * 131 + c * 4091) % 4096;
+                }
+        for (double sigma_spatial : {2.0, 0.5}) {
+            std::string what = "bilateral_filter sigma_spatial=" + std::to_string(sigma_spatial).substr(0, 3);
+            Mat3D out = ImageFilter::bilateral_filter(step, sigma_spatial, kBilateralRange);
+            check.expect("bilateral", what + " step edge", out,
+                         brute_force_bilateral(step, sigma_spatial, kBilateralRange));
+            // 保边：紧邻边缘两侧的平均灰度差应保持接近原始的60 HU
+            double low = 0.0, high = 0.0;
+            for (int z = 0; z < depth; ++z)
+                for (int r = 0; r < rows; ++r) {
+                    low += out[z][r][cols / 2 - 1];
+                    high += out[z][r][cols / 2];
+                }
+            check.require(what + " keeps the 60 HU step edge",
+                          (high - low) / (depth * rows) > 55.0);
+        }
+        check.expect("bilateral", "bilateral_filter 4096 HU span", ImageFilter::bilateral_filter(wide, 2.0, kBilateralRange),
+                     brute_force_bilateral(wide, 2.0, kBilateralRange));
+    }
+
+    for (const auto& entry : check.worst) {
+        std::cout << "tolerance " << entry.first << ": max abs error " << entry.second
+                  << " (threshold " << thresholds.tolerance.at(entry.first) << ")" << std::endl;
+    }
+    std::cout << check.checks - check.failures << "/" << check.checks << " golden checks passed" << std::endl;
+    return check.failures == 0 ? 0 : 1;
+}
+
+// 取多次运行中的最短耗时，换算为每秒处理的百万体素数
+static double measure(size_t voxels, const std::function<void()>& fn, int repeats = 7) {
+    double best = INFINITY;
+    for (int i = 0; i < repeats; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    return voxels / best / 1e6;
+}
+
+// 测量各执行路径的吞吐量；record为true时只输出本机实测值（阈值文件格式）
+static int run_throughput(const std::string& dir, bool record) {
+    Thresholds thresholds = load_thresholds(dir + "/thresholds.txt");
+    if (const char* baseline = std::getenv("FILTER_THROUGHPUT_BASELINE")) {
+        for (const auto& entry : load_thresholds(baseline).throughput) {
+            thresholds.throughput[entry.first] = entry.second;
+        }
+    }
+    const int depth = 64, rows = 128, cols = 128;
+    const size_t voxels = static_cast<size_t>(depth) * rows * cols;
+    const double sigma = 2.0;
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 4095);
+    Mat3D vol(depth, Mat2D(rows, std::vector<double>(cols)));
+    for (auto& slice : vol)
+        for (auto& row : slice)
+            for (double& v : row) v = dist(gen);
+    Mat3DI vol_int = ImageFilter::to_int_volume(vol);
+    VolumeBatch batch = ImageFilter::make_batch({vol, vol});
+    GaussianCache cache;
+    Mat3D cached = ImageFilter::gaussian_filter_cached(vol, sigma, cache);
+
+    std::map<std::string, std::function<double()>> benches;
+    benches["serial_gaussian"] = [&] { return measure(voxels, [&] { ImageFilter::gaussian_filter(vol, sigma); }); };
+    benches["serial_sobel"] = [&] { return measure(voxels, [&] { ImageFilter::sobel(vol, 0); }); };
+    benches["threaded_batch_gaussian"] = [&] {
+        return measure(2 * voxels, [&] { ImageFilter::gaussian_filter_batch(batch, sigma); });
+    };
+    benches["threaded_numa_gaussian"] = [&] {
+        return measure(voxels, [&] { ImageFilter::gaussian_filter_numa(vol, sigma); });
+    };
+    benches["integer_gaussian"] = [&] {
+        return measure(voxels, [&] { ImageFilter::gaussian_filter_int(vol_int, sigma); });
+    };
+    benches["integer_sobel"] = [&] { return measure(voxels, [&] { ImageFilter::sobel_int(vol_int, 0); }); };
+    // 增量更新按整卷体素数折算：只修改一张切片时应远快于整卷重算
+    benches["incremental_update"] = [&] {
+        return measure(voxels, [&] {
+            ImageFilter::gaussian_filter_update(vol, {{depth / 2, depth / 2 + 1}}, cache, cached);
+        });
+    };
+    // 降采样按输入体素数折算
+    benches["decimated_gaussian"] = [&] {
+        return measure(voxels, [&] { ImageFilter::gaussian_downsample(vol, sigma, {2, 2, 2}); });
+    };
+
+    int failures = 0;
+    for (const auto& bench : benches) {
+        double value = bench.second();
+        if (record) {
+            std::cout << "throughput " << bench.first << " " << value << std::endl;
+            continue;
+        }
+        auto it = thresholds.throughput.find(bench.first);
+        if (it == thresholds.throughput.end()) throw std::runtime_error("No throughput recorded for " + bench.first);
+        double minimum = it->second * kThroughputFraction;
+        // 低于下限时最多重测两次，排除偶发的调度干扰
+        for (int retry = 0; retry < 2 && value < minimum; ++retry) value = std::max(value, bench.second());
+        bool ok = value >= minimum;
+        if (!ok) ++failures;
+        std::cout << (ok ? "ok   " : "FAIL ") << bench.first << ": " << value << " Mvox/s (baseline "
+                  << it->second << ", minimum " << minimum << ")" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " golden|throughput|record <golden_dir>" << std::endl;
+        return 2;
+    }
+    try {
+        std::string mode = argv[1];
+        if (mode == "golden") return run_golden(argv[2]);
+        if (mode == "throughput") return run_throughput(argv[2], false);
+        if (mode == "record") return run_throughput(argv[2], true);
+        std::cerr << "Unknown test mode: " << mode << std::endl;
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << "错误：" << e.what() << std::endl;
+        return 1;
+    }
+}
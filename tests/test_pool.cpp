@@ -0,0 +1,114 @@
+// VolumePool测试：默认不缓存、设置上限后才缓存，以及超出上限时的立即失败与阻塞等待。
+//
+// 用法：poolTests
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include "ImageFilter.h"
+#include "VolumePool.h"
+
+
+static const int kDepth = 9, kRows = 10, kCols = 11;
+static const size_t kVolumeBytes = static_cast<size_t>(kDepth) * kRows * kCols * sizeof(double);
+
+static int checks = 0;
+static int failures = 0;
+
+static void require(const std::string& what, bool ok) {
+    ++checks;
+    if (!ok) {
+        ++failures;
+        std::cerr << "FAIL " << what << std::endl;
+    }
+}
+
+// 调用fn并判断是否抛出std::runtime_error
+static bool throws_runtime_error(const std::function<void()>& fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static Mat3D make_volume() {
+    Mat3D vol(kDepth, Mat2D(kRows, std::vector<double>(kCols)));
+    for (int z = 0; z < kDepth; ++z)
+        for (int r = 0; r < kRows; ++r)
+            for (int c = 0; c < kCols; ++c) vol[z][r][c] = (z * 977 + r * 131 + c * 41) % 4096;
+    return vol;
+}
+
+int main() {
+    VolumePool& pool = VolumePool::instance();
+    Mat3D vol = make_volume();
+
+    // 默认不设上限：滤波调用结束后既无借出也无缓存
+    pool.set_limit(0);
+    ImageFilter::gaussian_filter(vol, 1.0);
+    ImageFilter::sobel(vol, 0);
+    ImageFilter::bilateral_filter(vol, 2.0, 80.0);
+    PoolStats s = pool.stats();
+    require("no limit: nothing cached after gaussian/sobel/bilateral", s.bytes_cached == 0);
+    require("no limit: nothing in use after gaussian/sobel/bilateral", s.bytes_in_use == 0);
+
+    // 设置上限后缓存复用，trim与取消上限都会释放缓存
+    pool.set_limit(size_t(64) << 20);
+    ImageFilter::gaussian_filter(vol, 1.0);
+    require("limit set: temporaries are cached", pool.stats().bytes_cached > 0);
+    pool.trim();
+    require("trim releases the cache", pool.stats().bytes_cached == 0);
+    ImageFilter::gaussian_filter(vol, 1.0);
+    pool.set_limit(0);
+    require("clearing the limit releases the cache", pool.stats().bytes_cached == 0);
+
+    // 立即失败模式：超出上限时抛出异常，已借出的中间结果全部归还
+    pool.set_limit(3 * kVolumeBytes, false);
+    require("fail-fast: gaussian_filter over the limit throws",
+            throws_runtime_error([&] { ImageFilter::gaussian_filter(vol, 1.0); }));
+    require("fail-fast: nothing left in use", pool.stats().bytes_in_use == 0);
+
+    // 阻塞模式、只有调用线程在借用：等待不可能结束，应立即抛出而不是挂起
+    pool.set_limit(3 * kVolumeBytes, true);
+    size_t waits = pool.stats().waits;
+    require("blocking, single borrower: gaussian_filter over the limit throws",
+            throws_runtime_error([&] { ImageFilter::gaussian_filter(vol, 1.0); }));
+    require("blocking, single borrower: did not wait", pool.stats().waits == waits);
+    require("blocking, single borrower: nothing left in use", pool.stats().bytes_in_use == 0);
+
+    // 阻塞模式、另一线程占用大部分额度：借出请求等待该线程归还后成功
+    pool.set_limit(4 * kVolumeBytes, true);
+    waits = pool.stats().waits;
+    std::promise<void> held;
+    std::thread holder([&] {
+        PooledBuffer buffer(7 * kVolumeBytes / 2 / sizeof(double));
+        held.set_value();
+        // 确认主线程已进入等待后再归还（最多等5秒）
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (pool.stats().waits == waits && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    held.get_future().wait();
+    bool acquired = !throws_runtime_error([&] {
+        Mat3D volume = pool.acquire(kDepth, kRows, kCols);
+        pool.release(std::move(volume));
+    });
+    holder.join();
+    require("blocking, other borrower: acquire succeeds after the other thread releases", acquired);
+    require("blocking, other borrower: acquire waited", pool.stats().waits > waits);
+
+    pool.set_limit(0);
+    require("all memory returned", pool.stats().bytes_in_use == 0 && pool.stats().bytes_cached == 0);
+
+    std::cout << checks - failures << "/" << checks << " pool checks passed" << std::endl;
+    return failures == 0 ? 0 : 1;
+}